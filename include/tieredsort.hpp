@@ -33,13 +33,19 @@
  * How it works:
  *   Tier 1: Small arrays (n < 256) → pdqsort/introsort
  *   Tier 2: Patterned data (sorted/reversed) → pdqsort O(n)
- *   Tier 3: Dense ranges (range ≤ 2n) → counting sort O(n + range)
+ *   Tier 3: Dense ranges (range ≤ 2n, incl. whole-number floats) → counting sort O(n + range)
+ *   Tier 3b: Few distinct values (≤ 64, any range) → hash counting O(n)
+ *   Tier 3c: Heavy hitters (skewed data) → count them, radix sort the tail
  *   Tier 4: Random data → radix sort O(n)
  *
  * Supported types:
+ *   - int8_t, uint8_t, int16_t, uint16_t, char types (direct counting sort)
  *   - int32_t, uint32_t
  *   - int64_t, uint64_t
  *   - float, double (via bit manipulation)
+ *   - __int128, unsigned __int128 (GCC/Clang; MSD radix with pass skipping)
+ *   - _Float16, __bf16, tiered::bfloat16 (direct counting over 65536 keys)
+ *   - std::array<uint8_t, N> keys via sort_by_byte_key()
  *
  * Usage:
  *   #include "tieredsort.hpp"
@@ -58,17 +64,426 @@
 #define TIEREDSORT_HPP
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iterator>
 #include <type_traits>
 #include <vector>
+#include <memory>
 #include <limits>
+#include <array>
+#include <string_view>
+#include <utility>
+
+// 128-bit integers are a GCC/Clang extension (not available on MSVC)
+#if defined(__SIZEOF_INT128__) && !defined(TIEREDSORT_HAS_INT128)
+#define TIEREDSORT_HAS_INT128 1
+#endif
+
+// Native half-precision types, where the compiler provides them
+#if defined(__FLT16_MAX__) && !defined(TIEREDSORT_HAS_FLOAT16)
+#define TIEREDSORT_HAS_FLOAT16 1
+#endif
+#if defined(__BFLT16_MAX__) && !defined(TIEREDSORT_HAS_BF16)
+#define TIEREDSORT_HAS_BF16 1
+#endif
+
+// std::pmr (scratch from a memory_resource) where the standard library ships
+// it; libstdc++ before GCC 9 does not
+#if defined(__has_include) && !defined(TIEREDSORT_HAS_PMR)
+#if __has_include(<memory_resource>)
+#define TIEREDSORT_HAS_PMR 1
+#endif
+#endif
+#ifdef TIEREDSORT_HAS_PMR
+#include <memory_resource>
+#endif
+
+// Transparent huge pages for large temp buffers: build with
+// TIEREDSORT_HUGE_PAGES=1 (Linux only, madvise) to map them. Off by default,
+// which keeps <sys/mman.h> and its macros out of the includer's namespace.
+#ifndef TIEREDSORT_HUGE_PAGES
+#define TIEREDSORT_HUGE_PAGES 0
+#endif
+#if TIEREDSORT_HUGE_PAGES && defined(__linux__) && !defined(TIEREDSORT_HAS_HUGE_PAGES)
+#define TIEREDSORT_HAS_HUGE_PAGES 1
+#endif
+#ifdef TIEREDSORT_HAS_HUGE_PAGES
+#include <sys/mman.h>
+#endif
+
+// With TIEREDSORT_HUGE_PAGES, radix temp buffers of at least this many bytes
+// are mapped on huge pages and left untouched until the scatter writes them.
+// Set to 0 to disable.
+#ifndef TIEREDSORT_HUGE_PAGE_MIN
+#define TIEREDSORT_HUGE_PAGE_MIN (size_t(1) << 24)
+#endif
+
+// Tier telemetry: build with TIEREDSORT_STATS=1 (in every translation unit)
+// to record which tier each sort takes, with detection and sort timings, in
+// tiered::global_stats(). Off by default: the hooks then compile to nothing.
+#ifndef TIEREDSORT_STATS
+#define TIEREDSORT_STATS 0
+#endif
+#if TIEREDSORT_STATS
+#include <atomic>
+#include <chrono>
+#endif
+
+// Elements sampled before the dense-range full scan. More samples reject
+// sparse inputs more reliably; fewer make detection cheaper on tiny arrays.
+#ifndef TIEREDSORT_DENSE_SAMPLES
+#define TIEREDSORT_DENSE_SAMPLES 64
+#endif
 
 namespace tiered {
 
+/**
+ * bfloat16 storage type: 1 sign, 8 exponent and 7 mantissa bits, i.e. the
+ * upper half of an IEEE float. Layout-compatible with the bf16 types of ML
+ * frameworks, so their buffers can be sorted through a bfloat16 pointer.
+ */
+struct bfloat16 {
+    uint16_t bits;
+
+    // Round to nearest even; NaNs stay quiet NaNs
+    static bfloat16 from_float(float f) {
+        uint32_t u;
+        std::memcpy(&u, &f, sizeof(u));
+        if ((u & 0x7FFFFFFFu) > 0x7F800000u) {
+            return bfloat16{static_cast<uint16_t>((u >> 16) | 0x0040u)};
+        }
+        u += 0x7FFFu + ((u >> 16) & 1u);
+        return bfloat16{static_cast<uint16_t>(u >> 16)};
+    }
+
+    float to_float() const {
+        uint32_t u = static_cast<uint32_t>(bits) << 16;
+        float f;
+        std::memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+
+    friend bool operator==(bfloat16 a, bfloat16 b) { return a.bits == b.bits; }
+    friend bool operator!=(bfloat16 a, bfloat16 b) { return a.bits != b.bits; }
+};
+
+/**
+ * The tier a sort is dispatched to (see "How it works").
+ */
+enum class tier : uint8_t {
+    small,            // n < 256: std::sort / std::stable_sort
+    direct_counting,  // 8/16-bit types: histogram of the whole value space
+    pattern,          // sorted or reversed: comparison sort, O(n)
+    dense,            // dense key range: counting sort
+    few_distinct,     // at most 64 distinct values: hash counting
+    heavy_hitters,    // skewed: count the heavy values, radix sort the tail
+    radix,            // radix sort (LSD; MSD for 128-bit keys)
+    radix_in_place,   // sort_bounded without room for the temp buffer
+    comparison        // sort_by_key on sparse keys: std::stable_sort
+};
+
+inline constexpr size_t tier_count = 9;
+
+/** Name of a tier, for logs and metric labels. */
+inline const char* tier_name(tier t) {
+    static const char* const names[tier_count] = {
+        "small", "direct_counting", "pattern", "dense", "few_distinct",
+        "heavy_hitters", "radix", "radix_in_place", "comparison"
+    };
+    return names[static_cast<size_t>(t)];
+}
+
+#if TIEREDSORT_STATS
+
+/**
+ * One sort, as recorded with TIEREDSORT_STATS. Keys are the radix keys the
+ * tiers work on (order-preserving unsigned images of the elements).
+ */
+struct sort_event {
+    tier chosen = tier::small;
+    size_t n = 0;
+    size_t element_bytes = 0;
+
+    bool dense_sampled = false;        // the dense-range sample was taken
+    bool dense_sample_passed = false;  // ... and its range suggested dense data
+    uint64_t min_key = 0;              // sampled key bounds, exact once dense
+    uint64_t max_key = 0;
+
+    uint64_t radix_passes = 0;         // histogram + scatter passes run
+    uint64_t radix_passes_skipped = 0; // MSD levels where all keys shared a byte
+    uint64_t bytes_allocated = 0;      // scratch taken from the heap or a memory_resource
+
+    uint64_t detect_ns = 0;            // start until the tier was chosen
+    uint64_t sort_ns = 0;              // tier chosen until done
+};
+
+/**
+ * Aggregated counters, as plain integers for export.
+ */
+struct stats_snapshot {
+    struct per_tier {
+        uint64_t sorts = 0;
+        uint64_t elements = 0;
+        uint64_t detect_ns = 0;
+        uint64_t sort_ns = 0;
+    };
+    per_tier tiers[tier_count];
+    uint64_t dense_samples = 0;
+    uint64_t dense_sample_rejects = 0;
+    uint64_t radix_passes = 0;
+    uint64_t radix_passes_skipped = 0;
+    uint64_t bytes_allocated = 0;
+};
+
+/**
+ * Process-wide counters every recorded sort is added to (relaxed atomics,
+ * so safe to read while other threads sort).
+ */
+class sort_stats {
+public:
+    void record(const sort_event& e) {
+        auto& t = tiers_[static_cast<size_t>(e.chosen)];
+        t.sorts.fetch_add(1, std::memory_order_relaxed);
+        t.elements.fetch_add(e.n, std::memory_order_relaxed);
+        t.detect_ns.fetch_add(e.detect_ns, std::memory_order_relaxed);
+        t.sort_ns.fetch_add(e.sort_ns, std::memory_order_relaxed);
+        if (e.dense_sampled) {
+            dense_samples_.fetch_add(1, std::memory_order_relaxed);
+            if (!e.dense_sample_passed) dense_sample_rejects_.fetch_add(1, std::memory_order_relaxed);
+        }
+        radix_passes_.fetch_add(e.radix_passes, std::memory_order_relaxed);
+        radix_passes_skipped_.fetch_add(e.radix_passes_skipped, std::memory_order_relaxed);
+        bytes_allocated_.fetch_add(e.bytes_allocated, std::memory_order_relaxed);
+    }
+
+    stats_snapshot snapshot() const {
+        stats_snapshot s;
+        for (size_t i = 0; i < tier_count; i++) {
+            s.tiers[i].sorts = tiers_[i].sorts.load(std::memory_order_relaxed);
+            s.tiers[i].elements = tiers_[i].elements.load(std::memory_order_relaxed);
+            s.tiers[i].detect_ns = tiers_[i].detect_ns.load(std::memory_order_relaxed);
+            s.tiers[i].sort_ns = tiers_[i].sort_ns.load(std::memory_order_relaxed);
+        }
+        s.dense_samples = dense_samples_.load(std::memory_order_relaxed);
+        s.dense_sample_rejects = dense_sample_rejects_.load(std::memory_order_relaxed);
+        s.radix_passes = radix_passes_.load(std::memory_order_relaxed);
+        s.radix_passes_skipped = radix_passes_skipped_.load(std::memory_order_relaxed);
+        s.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void reset() {
+        for (auto& t : tiers_) {
+            t.sorts.store(0, std::memory_order_relaxed);
+            t.elements.store(0, std::memory_order_relaxed);
+            t.detect_ns.store(0, std::memory_order_relaxed);
+            t.sort_ns.store(0, std::memory_order_relaxed);
+        }
+        dense_samples_.store(0, std::memory_order_relaxed);
+        dense_sample_rejects_.store(0, std::memory_order_relaxed);
+        radix_passes_.store(0, std::memory_order_relaxed);
+        radix_passes_skipped_.store(0, std::memory_order_relaxed);
+        bytes_allocated_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    struct counters {
+        std::atomic<uint64_t> sorts{0};
+        std::atomic<uint64_t> elements{0};
+        std::atomic<uint64_t> detect_ns{0};
+        std::atomic<uint64_t> sort_ns{0};
+    };
+    counters tiers_[tier_count];
+    std::atomic<uint64_t> dense_samples_{0};
+    std::atomic<uint64_t> dense_sample_rejects_{0};
+    std::atomic<uint64_t> radix_passes_{0};
+    std::atomic<uint64_t> radix_passes_skipped_{0};
+    std::atomic<uint64_t> bytes_allocated_{0};
+};
+
+/** The process-wide counters. */
+inline sort_stats& global_stats() {
+    static sort_stats stats;
+    return stats;
+}
+
+/**
+ * Callback run (on the sorting thread) with every recorded sort, after it
+ * is added to global_stats(). Pass nullptr to remove it.
+ */
+using stats_sink = void (*)(const sort_event&);
+
+namespace detail {
+inline std::atomic<stats_sink>& stats_sink_slot() {
+    static std::atomic<stats_sink> sink{nullptr};
+    return sink;
+}
+} // namespace detail
+
+inline void set_stats_sink(stats_sink sink) {
+    detail::stats_sink_slot().store(sink, std::memory_order_release);
+}
+
+#endif // TIEREDSORT_STATS
+
 namespace detail {
 
+// 8/16-bit integers: the whole value space fits in one histogram
+template<typename T>
+inline constexpr bool is_small_int_v =
+    std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 2;
+
+#ifdef TIEREDSORT_HAS_INT128
+__extension__ typedef __int128 int128;
+__extension__ typedef unsigned __int128 uint128;
+
+template<typename T>
+inline constexpr bool is_int128_v = std::is_same_v<T, int128> || std::is_same_v<T, uint128>;
+#else
+template<typename T>
+inline constexpr bool is_int128_v = false;
+#endif
+
+// 16-bit floats: sign-flip transform, then sorted like uint16_t
+template<typename T>
+inline constexpr bool is_half_float_v =
+    std::is_same_v<T, bfloat16>
+#ifdef TIEREDSORT_HAS_FLOAT16
+    || std::is_same_v<T, _Float16>
+#endif
+#ifdef TIEREDSORT_HAS_BF16
+    || std::is_same_v<T, __bf16>
+#endif
+    ;
+
+// Types whose full value space is counted directly (at most 65536 values)
+template<typename T>
+inline constexpr bool is_direct_countable_v = is_small_int_v<T> || is_half_float_v<T>;
+
+// Unsigned type holding the sortable key of a direct-countable type
+template<typename T>
+using small_key_t = std::conditional_t<sizeof(T) == 1, uint8_t, uint16_t>;
+
+template<typename T>
+inline constexpr bool is_sortable_v =
+    is_direct_countable_v<T> || is_int128_v<T> ||
+    std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
+    std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// =============================================================================
+// TELEMETRY HOOKS (no-ops unless TIEREDSORT_STATS)
+// =============================================================================
+
+#if TIEREDSORT_STATS
+
+using stats_clock = std::chrono::steady_clock;
+
+struct stats_state {
+    sort_event event;
+    stats_clock::time_point start;
+    stats_clock::time_point chosen;
+    bool decided = false;
+};
+
+// The sort in progress on this thread; null outside a tier dispatch
+inline stats_state*& current_stats() {
+    static thread_local stats_state* state = nullptr;
+    return state;
+}
+
+// Records one dispatch. Nested dispatches (a tier sorting a sub-range
+// through another entry point) count toward the outer one.
+class stats_scope {
+public:
+    stats_scope(size_t n, size_t element_bytes) {
+        if (current_stats()) return;
+        state_.event.n = n;
+        state_.event.element_bytes = element_bytes;
+        state_.start = stats_clock::now();
+        current_stats() = &state_;
+        owner_ = true;
+    }
+
+    stats_scope(const stats_scope&) = delete;
+    stats_scope& operator=(const stats_scope&) = delete;
+
+    ~stats_scope() {
+        if (!owner_) return;
+        current_stats() = nullptr;
+        auto end = stats_clock::now();
+        auto chosen = state_.decided ? state_.chosen : end;
+        state_.event.detect_ns = ns(chosen - state_.start);
+        state_.event.sort_ns = ns(end - chosen);
+        global_stats().record(state_.event);
+        if (stats_sink sink = stats_sink_slot().load(std::memory_order_acquire)) {
+            sink(state_.event);
+        }
+    }
+
+private:
+    static uint64_t ns(stats_clock::duration d) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    stats_state state_;
+    bool owner_ = false;
+};
+
+// The first tier noted is the one the dispatch chose; later notes come
+// from sub-sorts (a heavy-hitter tail, a 1-byte radix pass)
+inline void note_tier(tier t) {
+    stats_state* s = current_stats();
+    if (!s || s->decided) return;
+    s->event.chosen = t;
+    s->chosen = stats_clock::now();
+    s->decided = true;
+}
+
+inline void note_dense_sample(uint64_t min_key, uint64_t max_key, bool passed) {
+    if (stats_state* s = current_stats()) {
+        s->event.dense_sampled = true;
+        s->event.dense_sample_passed = passed;
+        s->event.min_key = min_key;
+        s->event.max_key = max_key;
+    }
+}
+
+inline void note_dense_bounds(uint64_t min_key, uint64_t max_key) {
+    if (stats_state* s = current_stats()) {
+        s->event.min_key = min_key;
+        s->event.max_key = max_key;
+    }
+}
+
+inline void note_radix_passes(uint64_t run, uint64_t skipped) {
+    if (stats_state* s = current_stats()) {
+        s->event.radix_passes += run;
+        s->event.radix_passes_skipped += skipped;
+    }
+}
+
+inline void note_alloc(size_t bytes) {
+    if (stats_state* s = current_stats()) s->event.bytes_allocated += bytes;
+}
+
+#else
+
+struct stats_scope {
+    stats_scope(size_t, size_t) {}
+};
+
+inline void note_tier(tier) {}
+inline void note_dense_sample(uint64_t, uint64_t, bool) {}
+inline void note_dense_bounds(uint64_t, uint64_t) {}
+inline void note_radix_passes(uint64_t, uint64_t) {}
+inline void note_alloc(size_t) {}
+
+#endif // TIEREDSORT_STATS
+
 // =============================================================================
 // TIER 4: RADIX SORT (LSD, 8-bit)
 // =============================================================================
@@ -79,6 +494,28 @@ inline uint64_t to_unsigned(int64_t v) { return static_cast<uint64_t>(v) ^ 0x800
 inline uint32_t to_unsigned(uint32_t v) { return v; }
 inline uint64_t to_unsigned(uint64_t v) { return v; }
 
+#ifdef TIEREDSORT_HAS_INT128
+inline uint128 to_unsigned(int128 v) { return static_cast<uint128>(v) ^ (uint128(1) << 127); }
+inline uint128 to_unsigned(uint128 v) { return v; }
+#endif
+
+// 8/16-bit integers (including char types): flip the sign bit if signed
+template<typename T>
+inline std::enable_if_t<is_small_int_v<T>, small_key_t<T>> to_unsigned(T v) {
+    using U = small_key_t<T>;
+    constexpr U bias = std::is_signed_v<T> ? U(U(1) << (sizeof(T) * 8 - 1)) : U(0);
+    return static_cast<U>(static_cast<U>(v) ^ bias);
+}
+
+// 16-bit floats (binary16 and bfloat16 share the sign bit position).
+// Negative NaNs sort before -inf, positive NaNs after +inf, -0 before +0.
+template<typename T>
+inline std::enable_if_t<is_half_float_v<T>, uint16_t> to_unsigned(T v) {
+    uint16_t bits;
+    std::memcpy(&bits, &v, sizeof(v));
+    return (bits & 0x8000u) ? static_cast<uint16_t>(~bits) : static_cast<uint16_t>(bits ^ 0x8000u);
+}
+
 // Float to sortable unsigned (IEEE 754 trick)
 inline uint32_t to_unsigned(float v) {
     uint32_t bits;
@@ -99,6 +536,25 @@ inline int64_t from_unsigned_i64(uint64_t v) { return static_cast<int64_t>(v ^ 0
 inline uint32_t from_unsigned_u32(uint32_t v) { return v; }
 inline uint64_t from_unsigned_u64(uint64_t v) { return v; }
 
+#ifdef TIEREDSORT_HAS_INT128
+inline int128 from_unsigned_i128(uint128 v) { return static_cast<int128>(v ^ (uint128(1) << 127)); }
+#endif
+
+// Inverse of to_unsigned for 8/16-bit integers and 16-bit floats
+template<typename T>
+inline T from_unsigned_small(small_key_t<T> v) {
+    if constexpr (is_half_float_v<T>) {
+        uint16_t bits = (v & 0x8000u) ? static_cast<uint16_t>(v ^ 0x8000u) : static_cast<uint16_t>(~v);
+        T result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    } else {
+        using U = std::make_unsigned_t<T>;
+        constexpr U bias = std::is_signed_v<T> ? U(U(1) << (sizeof(T) * 8 - 1)) : U(0);
+        return static_cast<T>(static_cast<U>(v ^ bias));
+    }
+}
+
 inline float from_unsigned_f32(uint32_t v) {
     v = (v & 0x80000000u) ? (v ^ 0x80000000u) : ~v;
     float result;
@@ -113,22 +569,38 @@ inline double from_unsigned_f64(uint64_t v) {
     return result;
 }
 
-// 32-bit radix sort (4 passes, 8 bits each)
-template<typename T>
-void radix_sort_32(T* arr, size_t n, T* temp) {
-    static_assert(sizeof(T) == 4, "radix_sort_32 requires 4-byte type");
-
-    uint32_t* src = reinterpret_cast<uint32_t*>(arr);
-    uint32_t* dst = reinterpret_cast<uint32_t*>(temp);
-
-    // Convert to unsigned
-    for (size_t i = 0; i < n; i++) {
-        src[i] = to_unsigned(arr[i]);
+// Inverse of to_unsigned for any supported type
+template<typename T, typename K>
+inline T from_unsigned_key(K v) {
+    if constexpr (is_direct_countable_v<T>) {
+        return from_unsigned_small<T>(static_cast<small_key_t<T>>(v));
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+        return from_unsigned_i32(static_cast<uint32_t>(v));
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return from_unsigned_i64(static_cast<uint64_t>(v));
+    } else if constexpr (std::is_same_v<T, float>) {
+        return from_unsigned_f32(static_cast<uint32_t>(v));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return from_unsigned_f64(static_cast<uint64_t>(v));
+#ifdef TIEREDSORT_HAS_INT128
+    } else if constexpr (std::is_same_v<T, int128>) {
+        return from_unsigned_i128(static_cast<uint128>(v));
+#endif
+    } else {
+        return static_cast<T>(v);
     }
+}
 
+// LSD passes over keys already converted to unsigned, 8 bits per pass.
+// Returns the buffer holding the sorted keys: `keys` after an even number
+// of passes (always, for the widths used here).
+template<typename K>
+K* radix_passes(K* keys, K* temp, size_t n) {
+    K* src = keys;
+    K* dst = temp;
     int count[256];
 
-    for (int shift = 0; shift < 32; shift += 8) {
+    for (int shift = 0; shift < static_cast<int>(sizeof(K) * 8); shift += 8) {
         std::memset(count, 0, sizeof(count));
 
         for (size_t i = 0; i < n; i++) {
@@ -145,6 +617,50 @@ void radix_sort_32(T* arr, size_t n, T* temp) {
 
         std::swap(src, dst);
     }
+    note_radix_passes(sizeof(K), 0);
+    return src;
+}
+
+// 16-bit radix sort (2 passes, 8 bits each)
+// Only used for arrays too small to amortize the 65536-bucket direct count.
+template<typename T, bool Descending = false>
+void radix_sort_16(T* arr, size_t n, T* temp) {
+    static_assert(sizeof(T) == 2, "radix_sort_16 requires 2-byte type");
+
+    constexpr uint16_t flip = Descending ? uint16_t(0xFFFF) : uint16_t(0);
+
+    uint16_t* src = reinterpret_cast<uint16_t*>(arr);
+
+    // Convert to unsigned
+    for (size_t i = 0; i < n; i++) {
+        src[i] = static_cast<uint16_t>(to_unsigned(arr[i]) ^ flip);
+    }
+
+    src = radix_passes(src, reinterpret_cast<uint16_t*>(temp), n);
+
+    // Two passes always leave the result in arr; convert back from unsigned
+    for (size_t i = 0; i < n; i++) {
+        arr[i] = from_unsigned_small<T>(static_cast<uint16_t>(src[i] ^ flip));
+    }
+}
+
+// 32-bit radix sort (4 passes, 8 bits each)
+// Descending order is folded into the key transform (keys are bit-inverted),
+// so it costs no extra pass.
+template<typename T, bool Descending = false>
+void radix_sort_32(T* arr, size_t n, T* temp) {
+    static_assert(sizeof(T) == 4, "radix_sort_32 requires 4-byte type");
+
+    constexpr uint32_t flip = Descending ? ~0u : 0u;
+
+    uint32_t* src = reinterpret_cast<uint32_t*>(arr);
+
+    // Convert to unsigned
+    for (size_t i = 0; i < n; i++) {
+        src[i] = to_unsigned(arr[i]) ^ flip;
+    }
+
+    src = radix_passes(src, reinterpret_cast<uint32_t*>(temp), n);
 
     // Convert back and ensure result is in arr
     if (src != reinterpret_cast<uint32_t*>(arr)) {
@@ -152,50 +668,37 @@ void radix_sort_32(T* arr, size_t n, T* temp) {
     }
 
     // Convert back from unsigned
+    uint32_t* u = reinterpret_cast<uint32_t*>(arr);
     if constexpr (std::is_same_v<T, int32_t>) {
         for (size_t i = 0; i < n; i++) {
-            arr[i] = from_unsigned_i32(reinterpret_cast<uint32_t*>(arr)[i]);
+            arr[i] = from_unsigned_i32(u[i] ^ flip);
         }
     } else if constexpr (std::is_same_v<T, float>) {
-        uint32_t* u = reinterpret_cast<uint32_t*>(arr);
         for (size_t i = 0; i < n; i++) {
-            arr[i] = from_unsigned_f32(u[i]);
+            arr[i] = from_unsigned_f32(u[i] ^ flip);
+        }
+    } else if constexpr (Descending) {
+        for (size_t i = 0; i < n; i++) {
+            u[i] ^= flip;
         }
     }
 }
 
 // 64-bit radix sort (8 passes, 8 bits each)
-template<typename T>
+template<typename T, bool Descending = false>
 void radix_sort_64(T* arr, size_t n, T* temp) {
     static_assert(sizeof(T) == 8, "radix_sort_64 requires 8-byte type");
 
+    constexpr uint64_t flip = Descending ? ~0ull : 0ull;
+
     uint64_t* src = reinterpret_cast<uint64_t*>(arr);
-    uint64_t* dst = reinterpret_cast<uint64_t*>(temp);
 
     // Convert to unsigned
     for (size_t i = 0; i < n; i++) {
-        src[i] = to_unsigned(arr[i]);
+        src[i] = to_unsigned(arr[i]) ^ flip;
     }
 
-    int count[256];
-
-    for (int shift = 0; shift < 64; shift += 8) {
-        std::memset(count, 0, sizeof(count));
-
-        for (size_t i = 0; i < n; i++) {
-            count[(src[i] >> shift) & 0xFF]++;
-        }
-
-        for (int i = 1; i < 256; i++) {
-            count[i] += count[i - 1];
-        }
-
-        for (size_t i = n; i-- > 0;) {
-            dst[--count[(src[i] >> shift) & 0xFF]] = src[i];
-        }
-
-        std::swap(src, dst);
-    }
+    src = radix_passes(src, reinterpret_cast<uint64_t*>(temp), n);
 
     // Convert back and ensure result is in arr
     if (src != reinterpret_cast<uint64_t*>(arr)) {
@@ -203,692 +706,4118 @@ void radix_sort_64(T* arr, size_t n, T* temp) {
     }
 
     // Convert back from unsigned
+    uint64_t* u = reinterpret_cast<uint64_t*>(arr);
     if constexpr (std::is_same_v<T, int64_t>) {
         for (size_t i = 0; i < n; i++) {
-            arr[i] = from_unsigned_i64(reinterpret_cast<uint64_t*>(arr)[i]);
+            arr[i] = from_unsigned_i64(u[i] ^ flip);
         }
     } else if constexpr (std::is_same_v<T, double>) {
-        uint64_t* u = reinterpret_cast<uint64_t*>(arr);
         for (size_t i = 0; i < n; i++) {
-            arr[i] = from_unsigned_f64(u[i]);
+            arr[i] = from_unsigned_f64(u[i] ^ flip);
+        }
+    } else if constexpr (Descending) {
+        for (size_t i = 0; i < n; i++) {
+            u[i] ^= flip;
         }
     }
 }
 
 // =============================================================================
-// TIER 3: COUNTING SORT (for dense integer ranges)
+// MSD RADIX SORT (128-bit and fixed-width byte keys)
 // =============================================================================
 
-// Unstable counting sort (faster, regenerates values)
-template<typename T>
-void counting_sort(T* arr, size_t n, T min_val, T max_val) {
-    static_assert(std::is_integral_v<T>, "counting_sort requires integral type");
+// Buckets at or below this size are finished with insertion sort
+constexpr size_t MSD_SMALL_BUCKET = 32;
+
+// Stable insertion sort for the small buckets left by the MSD passes
+template<typename T, typename Compare>
+void insertion_sort(T* arr, size_t n, Compare comp) {
+    for (size_t i = 1; i < n; i++) {
+        if (!comp(arr[i], arr[i - 1])) continue;
+        T tmp = std::move(arr[i]);
+        size_t j = i;
+        do {
+            arr[j] = std::move(arr[j - 1]);
+            j--;
+        } while (j > 0 && comp(tmp, arr[j - 1]));
+        arr[j] = std::move(tmp);
+    }
+}
 
-    size_t range = static_cast<size_t>(max_val - min_val + 1);
-    std::vector<size_t> count(range, 0);
+// MSD radix sort, one byte per level, most significant byte first.
+// digit(x, depth) returns byte `depth` of x's key (0 = most significant).
+//
+// Pass skipping: a level where every element shares the same byte moves
+// nothing - only its histogram is computed. Clustered high bytes (the
+// timestamp prefix of UUIDv7, small values in 128-bit integers) therefore
+// cost one read each instead of a full scatter.
+//
+// Every bucket but the largest is sorted by a recursive call; the largest
+// continues in this frame. Each call gets at most half the elements, so
+// the stack stays O(log n) deep whatever the key width.
+//
+// With `digits` (n bytes of scratch), each level calls digit() once per
+// element and the scatter reuses the byte: for keys that are costly to
+// fetch, such as byte arrays returned by value.
+//
+// The scatter iterates forward, so the sort is stable.
+template<typename T, typename DigitFunc, typename Compare>
+void msd_radix_sort(T* arr, T* temp, size_t n, size_t depth, size_t key_bytes,
+                    DigitFunc digit, Compare comp, uint8_t* digits = nullptr) {
+    size_t count[256];
+    size_t offset[256];
+
+    while (depth < key_bytes) {
+        if (n <= MSD_SMALL_BUCKET) {
+            insertion_sort(arr, n, comp);
+            return;
+        }
 
-    for (size_t i = 0; i < n; i++) {
-        count[static_cast<size_t>(arr[i] - min_val)]++;
-    }
+        std::memset(count, 0, sizeof(count));
+        uint8_t first;
+        if (digits) {
+            for (size_t i = 0; i < n; i++) {
+                digits[i] = static_cast<uint8_t>(digit(arr[i], depth));
+                count[digits[i]]++;
+            }
+            first = digits[0];
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                count[digit(arr[i], depth)]++;
+            }
+            first = static_cast<uint8_t>(digit(arr[0], depth));
+        }
+
+        // Skip the pass if every key has the same byte at this level
+        if (count[first] == n) {
+            note_radix_passes(0, 1);
+            depth++;
+            continue;
+        }
+        note_radix_passes(1, 0);
+
+        offset[0] = 0;
+        for (int i = 1; i < 256; i++) {
+            offset[i] = offset[i - 1] + count[i - 1];
+        }
 
-    size_t idx = 0;
-    for (size_t i = 0; i < range; i++) {
-        while (count[i]-- > 0) {
-            arr[idx++] = static_cast<T>(i) + min_val;
+        if (digits) {
+            for (size_t i = 0; i < n; i++) {
+                temp[offset[digits[i]]++] = std::move(arr[i]);
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                temp[offset[digit(arr[i], depth)]++] = std::move(arr[i]);
+            }
+        }
+        std::move(temp, temp + n, arr);
+
+        // Recurse into each bucket on the next byte, except the largest
+        int largest = 0;
+        for (int b = 1; b < 256; b++) {
+            if (count[b] > count[largest]) largest = b;
+        }
+        size_t start = 0;
+        size_t largest_start = 0;
+        for (int b = 0; b < 256; b++) {
+            if (b == largest) {
+                largest_start = start;
+            } else if (count[b] > 1) {
+                msd_radix_sort(arr + start, temp + start, count[b], depth + 1, key_bytes,
+                               digit, comp, digits ? digits + start : nullptr);
+            }
+            start += count[b];
         }
+
+        arr += largest_start;
+        temp += largest_start;
+        if (digits) digits += largest_start;
+        n = count[largest];
+        depth++;
     }
+    // All key bytes consumed: the remaining elements have equal keys
 }
 
-// Stable counting sort (preserves relative order of equal elements)
-template<typename T>
-void counting_sort_stable(T* arr, size_t n, T min_val, T max_val, T* temp) {
-    static_assert(std::is_integral_v<T>, "counting_sort requires integral type");
+#ifdef TIEREDSORT_HAS_INT128
+// 128-bit radix sort: MSD with pass skipping (16 levels worst case)
+template<typename T, bool Descending = false>
+void radix_sort_128(T* arr, size_t n, T* temp) {
+    static_assert(sizeof(T) == 16, "radix_sort_128 requires 16-byte type");
 
-    size_t range = static_cast<size_t>(max_val - min_val + 1);
-    std::vector<size_t> count(range, 0);
+    constexpr uint128 flip = Descending ? ~uint128(0) : uint128(0);
 
-    // Count occurrences
+    uint128* keys = reinterpret_cast<uint128*>(arr);
     for (size_t i = 0; i < n; i++) {
-        count[static_cast<size_t>(arr[i] - min_val)]++;
+        keys[i] = to_unsigned(arr[i]) ^ flip;
     }
 
-    // Convert to positions (prefix sum)
-    for (size_t i = 1; i < range; i++) {
-        count[i] += count[i - 1];
-    }
+    msd_radix_sort(keys, reinterpret_cast<uint128*>(temp), n, 0, 16,
+                   [](uint128 k, size_t depth) {
+                       return static_cast<uint8_t>(k >> (8 * (15 - depth)));
+                   },
+                   std::less<uint128>());
 
-    // Place elements in stable order (iterate backwards)
-    for (size_t i = n; i-- > 0;) {
-        size_t idx = static_cast<size_t>(arr[i] - min_val);
-        temp[--count[idx]] = arr[i];
+    // Convert back from unsigned
+    if constexpr (std::is_same_v<T, int128>) {
+        for (size_t i = 0; i < n; i++) {
+            arr[i] = from_unsigned_i128(keys[i] ^ flip);
+        }
+    } else if constexpr (Descending) {
+        for (size_t i = 0; i < n; i++) {
+            keys[i] ^= flip;
+        }
     }
-
-    // Copy back
-    std::memcpy(arr, temp, n * sizeof(T));
 }
+#endif
 
 // =============================================================================
-// TIER 2: PATTERN DETECTION (strict 3/3 check)
+// SCRATCH WORKSPACE (memory kept across calls by tiered::sorter)
 // =============================================================================
 
-template<typename T>
-bool is_pattern_sorted(const T* arr, size_t n) {
-    if (n < 8) return true;
-
-    size_t m = n / 2;
+// Growable scratch buffers. Tiers that are handed a workspace take their
+// count tables and buffers from it instead of the heap; a null workspace
+// means allocate per call. Blocks come from the memory_resource, if one is
+// given, else from operator new - or, for sort_bounded, are carved from a
+// fixed caller-owned arena, in which case get() returns null once a block
+// does not fit.
+class workspace {
+public:
+    enum slot : size_t { TEMP, COUNTS, REBASE, SLOTS };
+
+    workspace() = default;
+#ifdef TIEREDSORT_HAS_PMR
+    explicit workspace(std::pmr::memory_resource* resource) : resource_(resource) {}
+#endif
+    workspace(void* arena, size_t bytes)
+        : arena_(static_cast<unsigned char*>(arena)), arena_bytes_(bytes), bounded_(true) {}
+    workspace(const workspace&) = delete;
+    workspace& operator=(const workspace&) = delete;
+    workspace(workspace&& other) noexcept { swap(other); }
+    workspace& operator=(workspace&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+    ~workspace() { release(); }
+
+    // Storage for n objects of a trivially copyable type U; contents are
+    // unspecified and stay valid until the slot is requested again
+    template<typename U>
+    U* get(slot s, size_t n) {
+        static_assert(std::is_trivially_copyable_v<U>, "workspace only holds trivially copyable types");
+        static_assert(alignof(U) <= alignof(std::max_align_t), "over-aligned workspace type");
+        block& b = blocks_[s];
+        size_t bytes = n * sizeof(U);
+        if (b.bytes < bytes) {
+            if (bounded_) {
+                void* p = carve(bytes);
+                if (!p) return nullptr;
+                b.data = p;
+            } else {
+                // Nothing to preserve: free before allocating to keep the peak down
+                free_block(b);
+                b.data = allocate(bytes);
+            }
+            b.bytes = bytes;
+        }
+        return static_cast<U*>(b.data);
+    }
 
-    // Check head (positions 0,1,2,3)
-    bool head_asc = arr[0] <= arr[1] && arr[1] <= arr[2] && arr[2] <= arr[3];
-    bool head_desc = arr[0] >= arr[1] && arr[1] >= arr[2] && arr[2] >= arr[3];
-    if (!head_asc && !head_desc) return false;
+    // Frees every slot (an arena is rewound)
+    void release() {
+        for (auto& b : blocks_) free_block(b);
+        arena_used_ = 0;
+    }
 
-    // Check middle (positions m-1, m, m+1, m+2)
-    bool mid_asc = arr[m-1] <= arr[m] && arr[m] <= arr[m+1] && arr[m+1] <= arr[m+2];
-    bool mid_desc = arr[m-1] >= arr[m] && arr[m] >= arr[m+1] && arr[m+1] >= arr[m+2];
-    if (!mid_asc && !mid_desc) return false;
+    void swap(workspace& other) noexcept {
+        std::swap(blocks_, other.blocks_);
+        std::swap(arena_, other.arena_);
+        std::swap(arena_bytes_, other.arena_bytes_);
+        std::swap(arena_used_, other.arena_used_);
+        std::swap(bounded_, other.bounded_);
+#ifdef TIEREDSORT_HAS_PMR
+        std::swap(resource_, other.resource_);
+#endif
+    }
 
-    // Check tail (positions n-4, n-3, n-2, n-1)
-    bool tail_asc = arr[n-4] <= arr[n-3] && arr[n-3] <= arr[n-2] && arr[n-2] <= arr[n-1];
-    bool tail_desc = arr[n-4] >= arr[n-3] && arr[n-3] >= arr[n-2] && arr[n-2] >= arr[n-1];
-    if (!tail_asc && !tail_desc) return false;
+#ifdef TIEREDSORT_HAS_PMR
+    std::pmr::memory_resource* resource() const { return resource_; }
+#endif
+
+private:
+    struct block {
+        void* data = nullptr;
+        size_t bytes = 0;
+    };
+
+    void* allocate(size_t bytes) {
+        note_alloc(bytes);
+#ifdef TIEREDSORT_HAS_PMR
+        if (resource_) return resource_->allocate(bytes, alignof(std::max_align_t));
+#endif
+        return ::operator new(bytes);
+    }
 
-    return true;
-}
+    // Next max_align_t-aligned piece of the arena; arena blocks are never
+    // reused by another slot until release()
+    void* carve(size_t bytes) {
+        constexpr size_t align = alignof(std::max_align_t);
+        uintptr_t base = reinterpret_cast<uintptr_t>(arena_);
+        size_t offset = static_cast<size_t>(((base + arena_used_ + align - 1) & ~uintptr_t(align - 1)) - base);
+        if (offset > arena_bytes_ || bytes > arena_bytes_ - offset) return nullptr;
+        arena_used_ = offset + bytes;
+        return arena_ + offset;
+    }
 
-// =============================================================================
-// TIER 3: DENSE RANGE DETECTION (sampling)
-// =============================================================================
+    void free_block(block& b) {
+        if (!b.data) return;
+        if (bounded_) {
+            b = block();
+            return;
+        }
+#ifdef TIEREDSORT_HAS_PMR
+        if (resource_) {
+            resource_->deallocate(b.data, b.bytes, alignof(std::max_align_t));
+        } else {
+            ::operator delete(b.data);
+        }
+#else
+        ::operator delete(b.data);
+#endif
+        b = block();
+    }
 
-// Helper to compute range safely for any integer type (handles 64-bit overflow)
-template<typename T>
-inline uint64_t safe_range(T min_val, T max_val) {
-    if constexpr (sizeof(T) <= 4) {
-        // 32-bit types: safe to use int64_t arithmetic
-        return static_cast<uint64_t>(
-            static_cast<int64_t>(max_val) - static_cast<int64_t>(min_val) + 1
-        );
-    } else {
-        // 64-bit types: use unsigned arithmetic to avoid overflow
-        // Convert signed to unsigned sortable representation (flip sign bit)
-        uint64_t umax, umin;
-        if constexpr (std::is_signed_v<T>) {
-            umax = static_cast<uint64_t>(max_val) ^ 0x8000000000000000ull;
-            umin = static_cast<uint64_t>(min_val) ^ 0x8000000000000000ull;
+    block blocks_[SLOTS];
+    unsigned char* arena_ = nullptr;
+    size_t arena_bytes_ = 0;
+    size_t arena_used_ = 0;
+    bool bounded_ = false;
+#ifdef TIEREDSORT_HAS_PMR
+    std::pmr::memory_resource* resource_ = nullptr;
+#endif
+};
+
+// Counter table of n zeroed entries: from the workspace if there is one,
+// else owned
+template<typename Count>
+class count_table {
+public:
+    count_table(workspace* ws, workspace::slot s, size_t n) {
+        if (ws) {
+            data_ = ws->get<Count>(s, n);
+            std::fill_n(data_, n, Count(0));
         } else {
-            umax = static_cast<uint64_t>(max_val);
-            umin = static_cast<uint64_t>(min_val);
+            note_alloc(n * sizeof(Count));
+            owned_.assign(n, Count(0));
+            data_ = owned_.data();
         }
-        return umax - umin + 1;
     }
-}
 
-template<typename T>
-bool detect_dense_range(const T* arr, size_t n, T& out_min, T& out_max) {
-    static_assert(std::is_integral_v<T>, "dense range detection requires integral type");
+    Count* data() { return data_; }
+    Count& operator[](size_t i) { return data_[i]; }
 
-    // Sample 64 elements
-    T min_val = arr[0];
-    T max_val = arr[0];
-    size_t stride = std::max(size_t(1), n / 64);
+private:
+    Count* data_;
+    std::vector<Count> owned_;
+};
 
-    for (size_t i = 0; i < n; i += stride) {
-        if (arr[i] < min_val) min_val = arr[i];
-        if (arr[i] > max_val) max_val = arr[i];
-    }
+#ifdef TIEREDSORT_HAS_HUGE_PAGES
 
-    // Check if sampled range suggests dense data (using overflow-safe arithmetic)
-    uint64_t range_est = safe_range(min_val, max_val);
-    if (range_est > static_cast<uint64_t>(n)) {
-        return false;
-    }
+constexpr size_t HUGE_PAGE_BYTES = size_t(1) << 21;
 
-    // Full scan to get exact range
-    for (size_t i = 0; i < n; i++) {
-        if (arr[i] < min_val) min_val = arr[i];
-        if (arr[i] > max_val) max_val = arr[i];
+// Anonymous mapping aligned to (and advised for) 2 MB pages. The radix
+// scatter writes n random-ish destinations per pass; on 4 KB pages that is
+// a TLB miss per store once the buffer outgrows the TLB reach. There is no
+// up-front fill pass: the kernel zeroes each page on first touch, by the
+// thread that sorts into it, so it lands on that thread's NUMA node.
+class huge_page_block {
+public:
+    huge_page_block() = default;
+    huge_page_block(const huge_page_block&) = delete;
+    huge_page_block& operator=(const huge_page_block&) = delete;
+
+    ~huge_page_block() {
+        if (data_) munmap(data_, len_);
     }
 
-    uint64_t range = safe_range(min_val, max_val);
-    if (range <= static_cast<uint64_t>(n) * 2) {
-        out_min = min_val;
-        out_max = max_val;
-        return true;
+    // Map `bytes` (once); null if mmap fails
+    void* map(size_t bytes) {
+        size_t len = (bytes + HUGE_PAGE_BYTES - 1) & ~(HUGE_PAGE_BYTES - 1);
+        void* p = mmap(nullptr, len + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return nullptr;
+
+        // Trim the over-allocation so the block starts on a 2 MB boundary
+        uintptr_t start = reinterpret_cast<uintptr_t>(p);
+        uintptr_t aligned = (start + HUGE_PAGE_BYTES - 1) & ~(HUGE_PAGE_BYTES - 1);
+        if (aligned > start) munmap(p, aligned - start);
+        size_t tail = HUGE_PAGE_BYTES - (aligned - start);
+        if (tail) munmap(reinterpret_cast<void*>(aligned + len), tail);
+
+        data_ = reinterpret_cast<void*>(aligned);
+        len_ = len;
+#ifdef MADV_HUGEPAGE
+        madvise(data_, len_, MADV_HUGEPAGE);  // advisory: a no-op if THP is off
+#endif
+        return data_;
     }
 
-    return false;
-}
+private:
+    void* data_ = nullptr;
+    size_t len_ = 0;
+};
 
-// =============================================================================
-// MAIN TIEREDSORT IMPLEMENTATION
-// =============================================================================
+#endif
+
+// Radix temp buffer of n elements, taken when a lazily allocating tier
+// reaches the scatter: the workspace TEMP slot if there is one, else owned
+// (on huge pages from TIEREDSORT_HUGE_PAGE_MIN bytes). Owned storage is
+// default-initialised: the scatter overwrites it, so no zero-fill pass.
+template<typename T>
+class temp_buffer {
+public:
+    temp_buffer(workspace* ws, size_t n) {
+        if (ws) {
+            data_ = ws->get<T>(workspace::TEMP, n);
+            return;
+        }
+#ifdef TIEREDSORT_HAS_HUGE_PAGES
+        size_t bytes = n * sizeof(T);
+        if (TIEREDSORT_HUGE_PAGE_MIN > 0 && bytes >= TIEREDSORT_HUGE_PAGE_MIN) {
+            if (void* p = huge_.map(bytes)) {
+                note_alloc(bytes);
+                data_ = static_cast<T*>(p);
+                return;
+            }
+        }
+#endif
+        note_alloc(n * sizeof(T));
+        owned_.reset(new T[n]);
+        data_ = owned_.get();
+    }
+
+    T* data() { return data_; }
+
+private:
+    T* data_;
+    std::unique_ptr<T[]> owned_;
+#ifdef TIEREDSORT_HAS_HUGE_PAGES
+    huge_page_block huge_;
+#endif
+};
+
+// Insertion-sorted blocks before the first merge pass
+constexpr size_t STABLE_MERGE_BLOCK = 32;
+
+// Bottom-up merge sort through a caller-provided buffer of n elements:
+// the same result as std::stable_sort without its internal allocation.
+// Adjacent blocks already in order are moved, not merged.
+template<typename T, typename Compare>
+void stable_sort_buffered(T* arr, size_t n, T* temp, Compare comp) {
+    for (size_t lo = 0; lo < n; lo += STABLE_MERGE_BLOCK) {
+        size_t hi = std::min(n, lo + STABLE_MERGE_BLOCK);
+        for (size_t i = lo + 1; i < hi; i++) {
+            if (!comp(arr[i], arr[i - 1])) continue;
+            T v = std::move(arr[i]);
+            size_t j = i;
+            do {
+                arr[j] = std::move(arr[j - 1]);
+                j--;
+            } while (j > lo && comp(v, arr[j - 1]));
+            arr[j] = std::move(v);
+        }
+    }
+
+    T* src = arr;
+    T* dst = temp;
+    for (size_t width = STABLE_MERGE_BLOCK; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            size_t mid = std::min(n, lo + width);
+            size_t hi = std::min(n, lo + 2 * width);
+            if (mid == hi || !comp(src[mid], src[mid - 1])) {
+                std::move(src + lo, src + hi, dst + lo);
+            } else {
+                std::merge(std::make_move_iterator(src + lo), std::make_move_iterator(src + mid),
+                           std::make_move_iterator(src + mid), std::make_move_iterator(src + hi),
+                           dst + lo, comp);
+            }
+        }
+        std::swap(src, dst);
+    }
+    if (src != arr) {
+        std::move(src, src + n, arr);
+    }
+}
+
+// std::stable_sort, or its allocation-free twin when a workspace is
+// supplied (a null temp then takes the workspace TEMP slot)
+template<typename T, typename Compare>
+void stable_sort_small(T* arr, size_t n, T* temp, workspace* ws, Compare comp) {
+    if (ws) {
+        stable_sort_buffered(arr, n, temp ? temp : ws->get<T>(workspace::TEMP, n), comp);
+    } else {
+        std::stable_sort(arr, arr + n, comp);
+    }
+}
+
+// =============================================================================
+// DIRECT COUNTING SORT (8/16-bit integers, 16-bit floats)
+// =============================================================================
+
+// Below this size the 65536-bucket histogram (zeroing + walking it) costs
+// more than a 2-pass radix sort, so smaller 16-bit arrays use the regular tiers
+constexpr size_t DIRECT_COUNTING_MIN_16BIT = 65536;
+
+// Runs up to this length are written as one fixed-size block of stores
+constexpr size_t RUN_FILL_SHORT = 8;
+
+// Write `c` copies of `v` at `out` (counting-sort output). Short runs (the
+// common case for dense data, empty buckets included) store a fixed block
+// with no loop branch; the surplus is overwritten by the next run. Long
+// runs go to std::fill_n, which compiles to wide broadcast stores.
+template<typename T>
+inline T* fill_run(T* out, T* end, T v, size_t c) {
+    if (c <= RUN_FILL_SHORT && static_cast<size_t>(end - out) >= RUN_FILL_SHORT) {
+        for (size_t k = 0; k < RUN_FILL_SHORT; k++) {
+            out[k] = v;
+        }
+        return out + c;
+    }
+    return std::fill_n(out, c, v);
+}
+
+// Emit `count` copies of each bucket value, in bucket order
+template<typename T, bool Descending, typename Count>
+void emit_direct_counts(T* arr, size_t n, const Count* count, size_t buckets) {
+    using U = small_key_t<T>;
+
+    T* out = arr;
+    T* end = arr + n;
+    for (size_t b = 0; b < buckets; b++) {
+        size_t i = Descending ? buckets - 1 - b : b;
+        out = fill_run(out, end, from_unsigned_small<T>(static_cast<U>(i)), static_cast<size_t>(count[i]));
+    }
+}
+
+// Count every bit pattern of an 8/16-bit type, then hand the histogram to
+// `body(count, buckets)`
+template<typename T, typename Body>
+void with_direct_counts(const T* arr, size_t n, workspace* ws, Body&& body) {
+    constexpr size_t buckets = size_t(1) << (sizeof(T) * 8);
+    auto fill = [arr, n](auto* count) {
+        for (size_t i = 0; i < n; i++) {
+            count[to_unsigned(arr[i])]++;
+        }
+    };
+
+    if constexpr (sizeof(T) == 1) {
+        // 256 counters live on the stack
+        size_t count[buckets] = {};
+        fill(count);
+        body(static_cast<const size_t*>(count), buckets);
+    } else {
+        // 65536 counters are too large for small thread stacks (256 KB even
+        // with 32-bit counts), so this one histogram goes on the heap
+        if (n <= std::numeric_limits<uint32_t>::max()) {
+            count_table<uint32_t> count(ws, workspace::COUNTS, buckets);
+            fill(count.data());
+            body(static_cast<const uint32_t*>(count.data()), buckets);
+        } else {
+            count_table<size_t> count(ws, workspace::COUNTS, buckets);
+            fill(count.data());
+            body(static_cast<const size_t*>(count.data()), buckets);
+        }
+    }
+}
+
+// Counting sort over the full value space of an 8/16-bit type.
+// No sampling, no range detection and no temp buffer: every input is dense.
+// Values are regenerated from their exact bit patterns (NaN payloads and
+// signed zeros included), so this serves stable_sort too.
+template<typename T, bool Descending = false>
+void direct_counting_sort(T* arr, size_t n, workspace* ws = nullptr) {
+    static_assert(is_direct_countable_v<T>, "direct_counting_sort requires an 8/16-bit type");
+    note_tier(tier::direct_counting);
+
+    with_direct_counts(arr, n, ws, [arr, n](const auto* count, size_t buckets) {
+        emit_direct_counts<T, Descending>(arr, n, count, buckets);
+    });
+}
+
+// Whether an array skips detection and goes straight to direct counting
+template<typename T>
+inline bool use_direct_counting(size_t n) {
+    if constexpr (sizeof(T) == 1) {
+        return true;
+    } else {
+        return is_direct_countable_v<T> && n >= DIRECT_COUNTING_MIN_16BIT;
+    }
+}
+
+// Heap bytes of the direct-counting histogram (8-bit tables live on the
+// stack; 0 for types that are not direct-countable)
+template<typename T>
+constexpr size_t direct_counting_bytes(size_t n) {
+    if constexpr (sizeof(T) == 1 || !is_direct_countable_v<T>) {
+        (void)n;
+        return 0;
+    } else {
+        return (size_t(1) << (sizeof(T) * 8)) *
+               (n <= std::numeric_limits<uint32_t>::max() ? sizeof(uint32_t) : sizeof(size_t));
+    }
+}
+
+// Dispatch to the radix sort matching the element width
+template<typename T, bool Descending = false>
+void radix_sort(T* arr, size_t n, T* temp) {
+    note_tier(tier::radix);
+    if constexpr (sizeof(T) == 1) {
+        // A one-byte radix sort is a single counting pass
+        (void)temp;
+        direct_counting_sort<T, Descending>(arr, n);
+    } else if constexpr (sizeof(T) == 2) {
+        radix_sort_16<T, Descending>(arr, n, temp);
+#ifdef TIEREDSORT_HAS_INT128
+    } else if constexpr (sizeof(T) == 16) {
+        radix_sort_128<T, Descending>(arr, n, temp);
+#endif
+    } else if constexpr (sizeof(T) == 4) {
+        radix_sort_32<T, Descending>(arr, n, temp);
+    } else {
+        radix_sort_64<T, Descending>(arr, n, temp);
+    }
+}
+
+// Buckets at or below this size finish with a comparison sort in the
+// in-place MSD radix sort
+constexpr size_t MSD_INPLACE_SMALL = 64;
+
+// In-place MSD radix sort (American flag sort) for sort_bounded, when not
+// even the radix temp buffer fits: each level counts one byte, then cycles
+// elements into their buckets by swapping. O(n) per byte of key, no
+// buffer, unstable; levels where all keys share the byte are skipped.
+template<typename T, bool Descending = false>
+void msd_radix_inplace(T* arr, size_t n, size_t depth = 0) {
+    using K = decltype(to_unsigned(std::declval<T>()));
+    constexpr size_t key_bytes = sizeof(K);
+    auto key = [](const T& v) {
+        constexpr K flip = Descending ? static_cast<K>(~K(0)) : K(0);
+        return static_cast<K>(to_unsigned(v) ^ flip);
+    };
+    auto digit = [&key](const T& v, size_t d) {
+        return static_cast<size_t>((key(v) >> ((key_bytes - 1 - d) * 8)) & 0xFF);
+    };
+    note_tier(tier::radix_in_place);
+
+    size_t count[256];
+    while (depth < key_bytes) {
+        if (n <= MSD_INPLACE_SMALL) {
+            std::sort(arr, arr + n, [&key](const T& a, const T& b) { return key(a) < key(b); });
+            return;
+        }
+
+        std::memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < n; i++) {
+            count[digit(arr[i], depth)]++;
+        }
+
+        // Skip the level if every key has the same byte
+        if (count[digit(arr[0], depth)] == n) {
+            note_radix_passes(0, 1);
+            depth++;
+            continue;
+        }
+        note_radix_passes(1, 0);
+
+        size_t next[256];
+        size_t end[256];
+        size_t start = 0;
+        for (size_t b = 0; b < 256; b++) {
+            next[b] = start;
+            start += count[b];
+            end[b] = start;
+        }
+
+        // Carry each misplaced element to its bucket, taking the one it
+        // displaces, until the cycle comes back to bucket b
+        for (size_t b = 0; b < 256; b++) {
+            while (next[b] < end[b]) {
+                T v = arr[next[b]];
+                size_t d = digit(v, depth);
+                while (d != b) {
+                    std::swap(v, arr[next[d]++]);
+                    d = digit(v, depth);
+                }
+                arr[next[b]++] = v;
+            }
+        }
+
+        start = 0;
+        for (size_t b = 0; b < 256; b++) {
+            if (count[b] > 1) {
+                msd_radix_inplace<T, Descending>(arr + start, count[b], depth + 1);
+            }
+            start += count[b];
+        }
+        return;
+    }
+}
+
+// =============================================================================
+// TIER 3: COUNTING SORT (for dense integer ranges)
+// =============================================================================
+
+// Ranges up to this many buckets keep their counters on the stack
+constexpr size_t DENSE_STACK_BUCKETS = 2048;
+
+// Order-preserving map from elements to the dense tier's 64-bit keys.
+// Integers use their radix key; every value is valid.
+template<typename T>
+struct integer_keys {
+    using key_type = decltype(to_unsigned(std::declval<T>()));
+
+    static bool valid(const T*, size_t) { return true; }
+    static uint64_t key(T v) { return static_cast<uint64_t>(to_unsigned(v)); }
+    static T value(uint64_t k) { return from_unsigned_key<T>(static_cast<key_type>(k)); }
+};
+
+// Floats holding whole numbers (prices in cents, counts, quantized
+// readings) map to the radix key of their int64 value. Anything that would
+// not round-trip bit for bit (fractions, -0.0, NaN, |v| > 2^53) is invalid
+// and sends the array on to the radix tier.
+template<typename T>
+struct integral_float_keys {
+    static constexpr T LIMIT = static_cast<T>(9007199254740992.0);  // 2^53
+
+    static bool valid(const T* arr, size_t len) {
+        bool ok = true;
+        for (size_t i = 0; i < len; i++) {
+            T v = arr[i];
+            if (!(v >= -LIMIT && v <= LIMIT)) return false;
+            ok &= to_unsigned(static_cast<T>(static_cast<int64_t>(v))) == to_unsigned(v);
+        }
+        return ok;
+    }
+    static uint64_t key(T v) { return to_unsigned(static_cast<int64_t>(v)); }
+    static T value(uint64_t k) { return static_cast<T>(from_unsigned_i64(k)); }
+};
+
+// Key map used by the dense tier, for the types that have one
+template<typename T>
+using dense_keys_t = std::conditional_t<std::is_floating_point_v<T>, integral_float_keys<T>, integer_keys<T>>;
+
+template<typename T>
+inline constexpr bool has_dense_tier_v =
+    (std::is_integral_v<T> && !is_int128_v<T>) || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Histogram of a dense array, indexed by key: count[i] holds the number of
+// elements whose key is base + i. Buckets outside [lo, hi] are empty (the
+// window keeps some slack around the data).
+// Count is uint32_t whenever n fits: half the footprint and zeroing cost of
+// size_t counters, which matters since the window can reach 2n buckets.
+template<typename T, typename Count = uint32_t, typename Keys = dense_keys_t<T>>
+struct dense_histogram {
+    using count_type = Count;
+    using keys = Keys;
+
+    Count* count = nullptr;
+    size_t cap = 0;
+    uint64_t base = 0;
+    size_t lo = 0;
+    size_t hi = 0;
+
+    // Large histograms come from the workspace, if given
+    workspace* ws = nullptr;
+
+    explicit dense_histogram(workspace* w = nullptr) : ws(w) {}
+    dense_histogram(const dense_histogram&) = delete;
+    dense_histogram& operator=(const dense_histogram&) = delete;
+
+    // Zeroed counters for `buckets` keys, on the stack when small. False if
+    // a bounded workspace has no room.
+    bool assign(size_t buckets) {
+        Count* table = take(buckets, slot_, true);
+        if (!table) return false;
+        count = table;
+        cap = buckets;
+        return true;
+    }
+
+    // Move the counts onto the window [new_base, new_base + buckets), which
+    // must hold every key counted so far. The new table is filled while the
+    // old one is live, so it comes from the other workspace slot.
+    bool rebase(uint64_t new_base, size_t buckets) {
+        Count* old = count;
+        size_t old_cap = cap;
+        std::vector<Count> old_heap;
+        if (old == heap_.data()) old_heap.swap(heap_);
+
+        workspace::slot next = slot_ == workspace::COUNTS ? workspace::REBASE : workspace::COUNTS;
+        Count* table = take(buckets, next, old != local_);
+        if (!table) return false;
+        for (size_t b = 0; b < old_cap; b++) {
+            if (old[b]) table[static_cast<size_t>(base + b - new_base)] = old[b];
+        }
+        count = table;
+        cap = buckets;
+        base = new_base;
+        slot_ = next;
+        return true;
+    }
+
+    T value(size_t i) const {
+        return Keys::value(base + i);
+    }
+
+private:
+    Count* take(size_t buckets, workspace::slot s, bool stack_ok) {
+        Count* table;
+        if (stack_ok && buckets <= DENSE_STACK_BUCKETS) {
+            table = local_;
+        } else if (ws) {
+            table = ws->get<Count>(s, buckets);
+            if (!table) return nullptr;
+        } else {
+            note_alloc(buckets * sizeof(Count));
+            heap_.assign(buckets, Count(0));
+            return heap_.data();
+        }
+        std::fill_n(table, buckets, Count(0));
+        return table;
+    }
+
+    Count local_[DENSE_STACK_BUCKETS];
+    std::vector<Count> heap_;
+    workspace::slot slot_ = workspace::COUNTS;
+};
+
+// Unstable counting sort (faster, regenerates values)
+// Descending order walks the counts in reverse.
+template<typename T, bool Descending = false, typename Count, typename Keys>
+void counting_sort(T* arr, size_t n, dense_histogram<T, Count, Keys>& h) {
+    static_assert(has_dense_tier_v<T>, "counting_sort requires an integer or float type");
+
+    const Count* count = h.count;
+    T* out = arr;
+    T* end = arr + n;
+    if constexpr (Descending) {
+        for (size_t i = h.hi + 1; i-- > h.lo;) {
+            out = fill_run(out, end, h.value(i), static_cast<size_t>(count[i]));
+        }
+    } else {
+        for (size_t i = h.lo; i <= h.hi; i++) {
+            out = fill_run(out, end, h.value(i), static_cast<size_t>(count[i]));
+        }
+    }
+}
+
+// Stable counting sort (preserves relative order of equal elements)
+template<typename T, bool Descending = false, typename Count, typename Keys>
+void counting_sort_stable(T* arr, size_t n, dense_histogram<T, Count, Keys>& h, T* temp) {
+    static_assert(has_dense_tier_v<T>, "counting_sort requires an integer or float type");
+
+    Count* count = h.count;
+
+    // Convert to positions (prefix sum, or suffix sum for descending)
+    if constexpr (Descending) {
+        for (size_t i = h.hi; i-- > h.lo;) {
+            count[i] += count[i + 1];
+        }
+    } else {
+        for (size_t i = h.lo + 1; i <= h.hi; i++) {
+            count[i] += count[i - 1];
+        }
+    }
+
+    // Place elements in stable order (iterate backwards)
+    const uint64_t base = h.base;
+    for (size_t i = n; i-- > 0;) {
+        size_t idx = static_cast<size_t>(Keys::key(arr[i]) - base);
+        temp[--count[idx]] = arr[i];
+    }
+
+    // Copy back
+    std::memcpy(arr, temp, n * sizeof(T));
+}
+
+// =============================================================================
+// TIER 2: PATTERN DETECTION (strict 3/3 check)
+// =============================================================================
+
+template<typename T>
+bool is_pattern_sorted_cmp(const T* arr, size_t n) {
+    if (n < 8) return true;
+
+    size_t m = n / 2;
+
+    // Check head (positions 0,1,2,3)
+    bool head_asc = arr[0] <= arr[1] && arr[1] <= arr[2] && arr[2] <= arr[3];
+    bool head_desc = arr[0] >= arr[1] && arr[1] >= arr[2] && arr[2] >= arr[3];
+    if (!head_asc && !head_desc) return false;
+
+    // Check middle (positions m-1, m, m+1, m+2)
+    bool mid_asc = arr[m-1] <= arr[m] && arr[m] <= arr[m+1] && arr[m+1] <= arr[m+2];
+    bool mid_desc = arr[m-1] >= arr[m] && arr[m] >= arr[m+1] && arr[m+1] >= arr[m+2];
+    if (!mid_asc && !mid_desc) return false;
+
+    // Check tail (positions n-4, n-3, n-2, n-1)
+    bool tail_asc = arr[n-4] <= arr[n-3] && arr[n-3] <= arr[n-2] && arr[n-2] <= arr[n-1];
+    bool tail_desc = arr[n-4] >= arr[n-3] && arr[n-3] >= arr[n-2] && arr[n-2] >= arr[n-1];
+    if (!tail_asc && !tail_desc) return false;
+
+    return true;
+}
+
+template<typename T>
+bool is_pattern_sorted(const T* arr, size_t n) {
+    if constexpr (is_half_float_v<T>) {
+        // 16-bit floats are always sorted in O(n) by radix/counting, and may
+        // lack comparison operators (bfloat16 storage type)
+        (void)arr; (void)n;
+        return false;
+    } else {
+        return is_pattern_sorted_cmp(arr, n);
+    }
+}
+
+// =============================================================================
+// TIER 3: DENSE RANGE DETECTION (sampling)
+// =============================================================================
+
+constexpr size_t DENSE_SAMPLE_SIZE = TIEREDSORT_DENSE_SAMPLES;
+static_assert(DENSE_SAMPLE_SIZE > 0, "TIEREDSORT_DENSE_SAMPLES must be positive");
+
+// The full range scan checks for an early exit once per block
+constexpr size_t DENSE_SCAN_BLOCK = 4096;
+
+// Position of sample j out of `samples`: one pseudo-random element inside
+// each of `samples` equal strata. Covers the array like a fixed stride,
+// but cannot fall in lockstep with periodic or blocked data.
+inline size_t sample_index(size_t j, size_t samples, size_t n) {
+    size_t stratum = n / samples;
+    if (stratum <= 1) return j;
+    uint64_t h = (static_cast<uint64_t>(j) + 1) * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 29;
+    return j * stratum + static_cast<size_t>(h % stratum);
+}
+
+// Sample the array: true if every sampled element has a key and the
+// sampled key range suggests dense data
+template<typename Keys, typename T>
+bool sample_dense_range(const T* arr, size_t n, uint64_t& out_min, uint64_t& out_max) {
+    // Sample (stratified, jittered)
+    uint64_t min_key = ~uint64_t(0);
+    uint64_t max_key = 0;
+    size_t samples = std::min(n, DENSE_SAMPLE_SIZE);
+
+    for (size_t j = 0; j < samples; j++) {
+        const T* v = arr + sample_index(j, samples, n);
+        if (!Keys::valid(v, 1)) {
+            note_dense_sample(0, 0, false);
+            return false;
+        }
+        uint64_t k = Keys::key(*v);
+        min_key = std::min(min_key, k);
+        max_key = std::max(max_key, k);
+    }
+
+    out_min = min_key;
+    out_max = max_key;
+    bool dense = max_key - min_key < static_cast<uint64_t>(n);
+    note_dense_sample(min_key, max_key, dense);
+    return dense;
+}
+
+// Exact key bounds of a dense array, found ahead of the sort by tiered::plan
+struct key_range {
+    uint64_t min_key = 0;
+    uint64_t max_key = 0;
+};
+
+// Exact key bounds of an array the dense tier would take, without counting
+// it: the sample, then one scan, abandoned once the range reaches 2n
+template<typename Keys, typename T>
+bool scan_dense_range(const T* arr, size_t n, key_range& range) {
+    uint64_t min_key, max_key;
+    if (!sample_dense_range<Keys>(arr, n, min_key, max_key)) {
+        return false;
+    }
+
+    const uint64_t limit = static_cast<uint64_t>(n) * 2;
+    for (size_t start = 0; start < n; start += DENSE_SCAN_BLOCK) {
+        size_t end = std::min(n, start + DENSE_SCAN_BLOCK);
+        if (!Keys::valid(arr + start, end - start)) return false;
+        for (size_t i = start; i < end; i++) {
+            min_key = std::min(min_key, Keys::key(arr[i]));
+            max_key = std::max(max_key, Keys::key(arr[i]));
+        }
+        if (max_key - min_key >= limit) return false;
+    }
+    range = {min_key, max_key};
+    return true;
+}
+
+// Dense range detection fused with the counting-sort histogram: once the
+// sample passes, a single pass counts straight into a window around the
+// sampled range (or exactly the `known` range, if the bounds were scanned
+// ahead, in which case no sample is taken). Each block is bounds-checked
+// with a (vectorizable) min/max while it is still in L1, then counted
+// without per-element checks. A block outside the window (rare: the window
+// has slack) triggers one scan of the remaining elements for their exact
+// bounds, abandoned as soon as the range exceeds 2n, and one rebase.
+// Returns false if not dense.
+template<typename T, typename Count, typename Keys>
+bool build_dense_histogram(const T* arr, size_t n, dense_histogram<T, Count, Keys>& h,
+                           const key_range* known = nullptr) {
+    static_assert(has_dense_tier_v<T>, "dense range detection requires an integer or float type");
+
+    auto key = [](T v) { return Keys::key(v); };
+    const uint64_t limit = static_cast<uint64_t>(n) * 2;
+    size_t cap;
+
+    if (known) {
+        if (known->max_key - known->min_key >= limit) return false;
+        h.base = known->min_key;
+        cap = static_cast<size_t>(known->max_key - known->min_key + 1);
+    } else {
+        uint64_t min_key, max_key;
+        if (!sample_dense_range<Keys>(arr, n, min_key, max_key)) {
+            return false;
+        }
+        const uint64_t sampled = max_key - min_key + 1;
+        const uint64_t slack = sampled / 8 + 64;
+        h.base = min_key >= slack ? min_key - slack : 0;
+        cap = static_cast<size_t>(std::min(limit, sampled + 2 * slack));
+    }
+    if (!h.assign(cap)) {
+        return false;
+    }
+    Count* count = h.count;
+    bool rebased = false;
+
+    for (size_t start = 0; start < n; start += DENSE_SCAN_BLOCK) {
+        size_t end = std::min(n, start + DENSE_SCAN_BLOCK);
+
+        if (!Keys::valid(arr + start, end - start)) {
+            return false;
+        }
+
+        if (!rebased) {
+            T lo = arr[start];
+            T hi = arr[start];
+            for (size_t i = start + 1; i < end; i++) {
+                lo = std::min(lo, arr[i]);
+                hi = std::max(hi, arr[i]);
+            }
+
+            if (key(lo) < h.base || key(hi) - h.base >= cap) {
+                // Exact bounds: what was counted so far, plus the rest
+                uint64_t mn = key(lo);
+                uint64_t mx = key(hi);
+                for (size_t b = 0; b < cap; b++) {
+                    if (count[b]) { mn = std::min(mn, h.base + b); break; }
+                }
+                for (size_t b = cap; b-- > 0;) {
+                    if (count[b]) { mx = std::max(mx, h.base + b); break; }
+                }
+                for (size_t rest = end; rest < n; rest += DENSE_SCAN_BLOCK) {
+                    if (mx - mn >= limit) break;
+                    size_t rest_end = std::min(n, rest + DENSE_SCAN_BLOCK);
+                    if (!Keys::valid(arr + rest, rest_end - rest)) return false;
+                    for (size_t i = rest; i < rest_end; i++) {
+                        mn = std::min(mn, key(arr[i]));
+                        mx = std::max(mx, key(arr[i]));
+                    }
+                }
+                if (mx - mn >= limit) {
+                    return false;
+                }
+
+                // Rebase onto the exact range; no block can miss any more
+                cap = static_cast<size_t>(mx - mn + 1);
+                if (!h.rebase(mn, cap)) {
+                    return false;
+                }
+                count = h.count;
+                rebased = true;
+            }
+        }
+
+        // Locals: the counters could alias h.base otherwise
+        const uint64_t base = h.base;
+        for (size_t i = start; i < end; i++) {
+            count[static_cast<size_t>(key(arr[i]) - base)]++;
+        }
+    }
+
+    h.lo = 0;
+    while (count[h.lo] == 0) h.lo++;
+    h.hi = cap - 1;
+    while (count[h.hi] == 0) h.hi--;
+    return true;
+}
+
+// Build the dense histogram with the narrowest counters that fit n and
+// hand it to `body`. Returns false (body not called) if not dense.
+template<typename T, typename Body>
+bool with_dense_histogram(const T* arr, size_t n, Body&& body, workspace* ws = nullptr,
+                          const key_range* known = nullptr) {
+    auto run = [&body](auto& hist) {
+        note_tier(tier::dense);
+        note_dense_bounds(hist.base + hist.lo, hist.base + hist.hi);
+        body(hist);
+    };
+    if (n <= std::numeric_limits<uint32_t>::max()) {
+        dense_histogram<T, uint32_t> hist(ws);
+        if (!build_dense_histogram(arr, n, hist, known)) return false;
+        run(hist);
+    } else {
+        dense_histogram<T, size_t> hist(ws);
+        if (!build_dense_histogram(arr, n, hist, known)) return false;
+        run(hist);
+    }
+    return true;
+}
+
+// Orders floating-point values by their radix key, so small and patterned
+// arrays agree with the counting/radix tiers on NaNs and signed zeros
+// (std::less leaves -0.0 and 0.0 interleaved, and is no strict weak order
+// once a NaN is present)
+template<typename T, bool Descending>
+struct sortable_key_less {
+    bool operator()(const T& a, const T& b) const {
+        if constexpr (Descending) {
+            return to_unsigned(b) < to_unsigned(a);
+        } else {
+            return to_unsigned(a) < to_unsigned(b);
+        }
+    }
+};
+
+// Comparator used by the comparison-based tiers (1 and 2)
+template<typename T, bool Descending>
+using order_compare = std::conditional_t<
+    is_half_float_v<T> || std::is_floating_point_v<T>, sortable_key_less<T, Descending>,
+    std::conditional_t<Descending, std::greater<T>, std::less<T>>>;
+
+// =============================================================================
+// TIER 3b: FEW DISTINCT VALUES (any range)
+// =============================================================================
+
+// Most distinct values the tier accepts, and how many elements it samples
+constexpr size_t FEW_DISTINCT_MAX = 64;
+constexpr size_t FEW_DISTINCT_SAMPLE = 256;
+
+// Open-addressing hash table of radix keys with their counts.
+// 256 slots for at most 64 keys keeps probe chains short.
+template<typename K>
+struct distinct_table {
+    static constexpr size_t SLOTS = 256;
+
+    K keys[SLOTS];
+    size_t counts[SLOTS];
+    bool used[SLOTS] = {};
+    size_t size = 0;
+
+    static size_t slot_of(K k) {
+        uint64_t h = static_cast<uint64_t>(k);
+        if constexpr (sizeof(K) > 8) {
+            h ^= static_cast<uint64_t>(k >> 64);
+        }
+        return static_cast<size_t>((h * 0x9E3779B97F4A7C15ull) >> 56);
+    }
+
+    // Add `c` occurrences of `k`. Returns false once the table would
+    // exceed FEW_DISTINCT_MAX keys.
+    bool add(K k, size_t c) {
+        size_t s = slot_of(k);
+        while (used[s]) {
+            if (keys[s] == k) {
+                counts[s] += c;
+                return true;
+            }
+            s = (s + 1) & (SLOTS - 1);
+        }
+        if (size == FEW_DISTINCT_MAX) return false;
+        used[s] = true;
+        keys[s] = k;
+        counts[s] = c;
+        size++;
+        return true;
+    }
+
+    // Count slot of `k`, or nullptr if it is not in the table
+    size_t* find(K k) {
+        size_t s = slot_of(k);
+        while (used[s]) {
+            if (keys[s] == k) return &counts[s];
+            s = (s + 1) & (SLOTS - 1);
+        }
+        return nullptr;
+    }
+
+    // Entries ordered by key
+    size_t sorted(std::pair<K, size_t>* out) const {
+        size_t m = 0;
+        for (size_t s = 0; s < SLOTS; s++) {
+            if (used[s]) out[m++] = {keys[s], counts[s]};
+        }
+        std::sort(out, out + m, [](const std::pair<K, size_t>& a, const std::pair<K, size_t>& b) {
+            return a.first < b.first;
+        });
+        return m;
+    }
+};
+
+// Add a strided sample of FEW_DISTINCT_SAMPLE keys to the table (with no
+// counts). False if the sample alone has too many distinct values.
+template<typename T, typename K>
+bool sample_few_distinct(const T* arr, size_t n, distinct_table<K>& table) {
+    for (size_t j = 0; j < FEW_DISTINCT_SAMPLE; j++) {
+        if (!table.add(to_unsigned(arr[j * n / FEW_DISTINCT_SAMPLE]), 0)) return false;
+    }
+    return true;
+}
+
+// Count every key of arr into the table, provided the array holds at most
+// FEW_DISTINCT_MAX distinct values. The sample rejects most inputs after
+// FEW_DISTINCT_SAMPLE lookups; the full pass then verifies the rest
+// (values the sample missed are still accepted while there is room).
+template<typename T, typename K>
+bool count_few_distinct(const T* arr, size_t n, distinct_table<K>& table) {
+    if (!sample_few_distinct(arr, n, table)) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (!table.add(to_unsigned(arr[i]), 1)) return false;
+    }
+    return true;
+}
+
+// Sort by counting into the sorted list of distinct values, regardless of
+// where they sit numerically. Values are rebuilt from their exact keys, so
+// this is valid for stable_sort too. Returns false if the input has too
+// many distinct values (arr is left untouched).
+template<typename T, bool Descending>
+bool few_distinct_sort(T* arr, size_t n) {
+    using K = decltype(to_unsigned(std::declval<T>()));
+    distinct_table<K> table;
+    if (!count_few_distinct(arr, n, table)) return false;
+    note_tier(tier::few_distinct);
+
+    std::pair<K, size_t> entries[FEW_DISTINCT_MAX];
+    size_t m = table.sorted(entries);
+    if constexpr (Descending) {
+        std::reverse(entries, entries + m);
+    }
+    T* out = arr;
+    for (size_t i = 0; i < m; i++) {
+        out = std::fill_n(out, entries[i].second, from_unsigned_key<T>(entries[i].first));
+    }
+    return true;
+}
+
+// =============================================================================
+// TIER 3c: HEAVY HITTERS (skewed / Zipf data)
+// =============================================================================
+
+// Smallest array worth sampling for heavy hitters
+constexpr size_t SKEW_MIN_N = 65536;
+constexpr size_t SKEW_SAMPLE = 1024;
+// A value is heavy if it fills this many sample slots (~0.4% of the data)
+constexpr size_t SKEW_HEAVY_MIN = 4;
+
+// Sample slots the heavy values must cover to pay for the extra counting
+// and splice passes (about two radix passes): 25% for 64-bit keys, 50%
+// for 32-bit keys
+template<typename K>
+constexpr size_t skew_min_coverage() {
+    constexpr size_t passes = sizeof(K) < 8 ? sizeof(K) : 8;
+    return SKEW_SAMPLE * 2 / passes;
+}
+
+// Collect the heavy values of a strided sample into `heavy`. Returns true
+// if together they cover enough of the sample; `covered_out` receives the
+// sample slots they fill.
+template<typename T, typename K>
+bool detect_heavy_hitters(const T* arr, size_t n, distinct_table<K>& heavy, size_t* covered_out = nullptr) {
+    K sample[SKEW_SAMPLE];
+    for (size_t j = 0; j < SKEW_SAMPLE; j++) {
+        sample[j] = to_unsigned(arr[j * n / SKEW_SAMPLE]);
+    }
+    std::sort(sample, sample + SKEW_SAMPLE);
+
+    size_t covered = 0;
+    for (size_t i = 0; i < SKEW_SAMPLE;) {
+        size_t j = i + 1;
+        while (j < SKEW_SAMPLE && sample[j] == sample[i]) j++;
+        if (j - i >= SKEW_HEAVY_MIN && heavy.add(sample[i], 0)) {
+            covered += j - i;
+        }
+        i = j;
+    }
+    if (covered_out) *covered_out = covered;
+    return covered >= skew_min_coverage<K>();
+}
+
+// Hybrid for skewed data: count the heavy values, radix sort only the
+// residual tail, then splice the heavy runs in. `temp` needs room for the
+// tail; pass nullptr to allocate exactly that much (from `ws`, if given).
+// Returns false (arr untouched) if the sample shows no significant heavy
+// hitters.
+template<typename T, bool Descending>
+bool heavy_hitter_sort(T* arr, size_t n, T* temp, workspace* ws = nullptr) {
+    using K = decltype(to_unsigned(std::declval<T>()));
+    if (n < SKEW_MIN_N) return false;
+
+    distinct_table<K> heavy;
+    if (!detect_heavy_hitters(arr, n, heavy)) return false;
+    note_tier(tier::heavy_hitters);
+
+    // Count heavy values and compact the tail to the front
+    size_t tail = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (size_t* c = heavy.find(to_unsigned(arr[i]))) {
+            (*c)++;
+        } else {
+            arr[tail++] = arr[i];
+        }
+    }
+
+    if (tail < 256) {
+        std::sort(arr, arr + tail, order_compare<T, Descending>());
+    } else if (temp) {
+        radix_sort<T, Descending>(arr, tail, temp);
+    } else {
+        // A bounded workspace may have no room: sort the tail in place
+        temp_buffer<T> tail_temp(ws, tail);
+        if (tail_temp.data()) {
+            radix_sort<T, Descending>(arr, tail, tail_temp.data());
+        } else {
+            msd_radix_inplace<T, Descending>(arr, tail);
+        }
+    }
+
+    // Splice from the back: the write position never passes the unread
+    // tail, so the merge needs no buffer. Tail keys never equal heavy keys.
+    constexpr K flip = Descending ? static_cast<K>(~K(0)) : K(0);
+    std::pair<K, size_t> entries[FEW_DISTINCT_MAX];
+    size_t m = heavy.sorted(entries);
+    if constexpr (Descending) {
+        std::reverse(entries, entries + m);
+    }
+    size_t w = n;
+    size_t ti = tail;
+    for (size_t h = m; h-- > 0;) {
+        K heavy_key = static_cast<K>(entries[h].first ^ flip);
+        while (ti > 0 && static_cast<K>(to_unsigned(arr[ti - 1]) ^ flip) > heavy_key) {
+            arr[--w] = arr[--ti];
+        }
+        w -= entries[h].second;
+        std::fill_n(arr + w, entries[h].second, from_unsigned_key<T>(entries[h].first));
+    }
+    return true;
+}
+
+// =============================================================================
+// MAIN TIEREDSORT IMPLEMENTATION
+// =============================================================================
 
 // For integral types (int32, int64, uint32, uint64)
+template<typename T, bool Descending = false>
+typename std::enable_if_t<std::is_integral_v<T> && !is_int128_v<T>>
+tieredsort_impl(T* arr, size_t n, T* temp, workspace* ws = nullptr) {
+    stats_scope stats(n, sizeof(T));
+
+    // Tier 1: Small arrays - use std::sort
+    if (n < 256) {
+        note_tier(tier::small);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    }
+
+    // 8/16-bit types: always dense - count the full value space directly
+    if constexpr (is_direct_countable_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            direct_counting_sort<T, Descending>(arr, n, ws);
+            return;
+        }
+    }
+
+    // Tier 2: Pattern detection - use std::sort for O(n) on sorted/reversed
+    if (is_pattern_sorted(arr, n)) {
+        note_tier(tier::pattern);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    }
+
+    // Tier 3: Dense range detection - use counting sort
+    if (with_dense_histogram(arr, n, [arr, n](auto& hist) { counting_sort<T, Descending>(arr, n, hist); }, ws)) {
+        return;
+    }
+
+    // Tier 3b: Few distinct values anywhere in the key space - count them
+    if (few_distinct_sort<T, Descending>(arr, n)) {
+        return;
+    }
+
+    // Tier 3c: Heavy hitters - count them, radix sort only the tail
+    if (heavy_hitter_sort<T, Descending>(arr, n, temp)) {
+        return;
+    }
+
+    // Tier 4: Radix sort for random data
+    radix_sort<T, Descending>(arr, n, temp);
+}
+
+// For floating point types (float, double, 16-bit floats) and 128-bit integers.
+// float and double take the dense tier when they hold whole numbers; 16-bit
+// floats count directly or skip it, and 128-bit keys get MSD pass skipping
+// instead.
+template<typename T, bool Descending = false>
+typename std::enable_if_t<std::is_floating_point_v<T> || is_half_float_v<T> || is_int128_v<T>>
+tieredsort_impl(T* arr, size_t n, T* temp, workspace* ws = nullptr) {
+    stats_scope stats(n, sizeof(T));
+
+    // Tier 1: Small arrays
+    if (n < 256) {
+        note_tier(tier::small);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    }
+
+    // 16-bit floats: 65536 bit patterns - count them directly
+    if constexpr (is_half_float_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            direct_counting_sort<T, Descending>(arr, n, ws);
+            return;
+        }
+    }
+
+    // Tier 2: Pattern detection
+    if (is_pattern_sorted(arr, n)) {
+        note_tier(tier::pattern);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    }
+
+    // Tier 3: Dense range of whole numbers (float and double only)
+    if constexpr (has_dense_tier_v<T>) {
+        if (with_dense_histogram(arr, n, [arr, n](auto& hist) { counting_sort<T, Descending>(arr, n, hist); }, ws)) {
+            return;
+        }
+    }
+
+    // Tier 3b: Few distinct values anywhere in the key space - count them
+    if (few_distinct_sort<T, Descending>(arr, n)) {
+        return;
+    }
+
+    // Tier 3c: Heavy hitters - count them, radix sort only the tail
+    if (heavy_hitter_sort<T, Descending>(arr, n, temp)) {
+        return;
+    }
+
+    // Tier 4: Radix sort
+    radix_sort<T, Descending>(arr, n, temp);
+}
+
+// Same tiers as tieredsort_impl, but the temp buffer is only allocated
+// once the radix tier is actually reached. With a workspace, every table
+// and buffer comes from it.
+template<typename T, bool Descending = false>
+void tieredsort_alloc_impl(T* arr, size_t n, workspace* ws = nullptr) {
+    stats_scope stats(n, sizeof(T));
+
+    // Tier 1: Small arrays - no allocation needed
+    if (n < 256) {
+        note_tier(tier::small);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    }
+
+    // 8/16-bit types: always dense - count the full value space directly
+    if constexpr (is_direct_countable_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            direct_counting_sort<T, Descending>(arr, n, ws);
+            return;
+        }
+    }
+
+    // Tier 2: Pattern detection - no allocation needed
+    if (is_pattern_sorted(arr, n)) {
+        note_tier(tier::pattern);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    }
+
+    // Tier 3: Dense range (integers up to 64 bits, integral-valued floats)
+    if constexpr (has_dense_tier_v<T>) {
+        if (with_dense_histogram(arr, n, [arr, n](auto& hist) { counting_sort<T, Descending>(arr, n, hist); }, ws)) {
+            return;
+        }
+    }
+
+    // Tier 3b: Few distinct values anywhere in the key space - count them
+    if (few_distinct_sort<T, Descending>(arr, n)) {
+        return;
+    }
+
+    // Tier 3c: Heavy hitters - count them, radix sort only the tail
+    if (heavy_hitter_sort<T, Descending>(arr, n, nullptr, ws)) {
+        return;
+    }
+
+    // Tier 4: Radix sort - only NOW allocate
+    temp_buffer<T> temp(ws, n);
+    radix_sort<T, Descending>(arr, n, temp.data());
+}
+
+// Tiers of tieredsort_alloc_impl inside the fixed arena of a bounded
+// workspace. A tier whose tables or buffer do not fit gives way to the next
+// one, and each tier starts with the whole arena; with no room for the
+// temp buffer the radix tier runs in place.
+template<typename T, bool Descending = false>
+void tieredsort_bounded_impl(T* arr, size_t n, workspace& ws) {
+    stats_scope stats(n, sizeof(T));
+
+    // Tier 1: Small arrays - std::sort needs no heap
+    if (n < 256) {
+        note_tier(tier::small);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    }
+
+    // 8/16-bit types: direct counting, if its histogram fits
+    if constexpr (is_direct_countable_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            size_t bytes = direct_counting_bytes<T>(n);
+            if (bytes == 0 || ws.get<unsigned char>(workspace::COUNTS, bytes)) {
+                direct_counting_sort<T, Descending>(arr, n, &ws);
+                return;
+            }
+        }
+    }
+
+    // Tier 2: Pattern detection
+    if (is_pattern_sorted(arr, n)) {
+        note_tier(tier::pattern);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    }
+
+    // Tier 3: Dense range - gives up if the histogram outgrows the arena
+    if constexpr (has_dense_tier_v<T>) {
+        if (with_dense_histogram(arr, n, [arr, n](auto& hist) { counting_sort<T, Descending>(arr, n, hist); }, &ws)) {
+            return;
+        }
+        ws.release();
+    }
+
+    // Tier 3b: Few distinct values (stack tables only)
+    if (few_distinct_sort<T, Descending>(arr, n)) {
+        return;
+    }
+
+    // Tier 3c: Heavy hitters - the tail is sorted in place if need be
+    if (heavy_hitter_sort<T, Descending>(arr, n, nullptr, &ws)) {
+        return;
+    }
+
+    // Tier 4: Radix sort, or in-place MSD radix without room for the buffer
+    if (T* temp = ws.get<T>(workspace::TEMP, n)) {
+        radix_sort<T, Descending>(arr, n, temp);
+    } else {
+        msd_radix_inplace<T, Descending>(arr, n);
+    }
+}
+
+// Tiers of tieredsort_alloc_impl from `start` on, for tiered::execute: the
+// checks in front of it already ran in tiered::plan, and `range` holds the
+// exact key bounds when it starts at the dense tier. Every tier still
+// verifies its input, so a plan that no longer matches the data costs
+// speed, never correctness.
+template<typename T, bool Descending = false>
+void tieredsort_planned_impl(T* arr, size_t n, tier start, const key_range& range) {
+    stats_scope stats(n, sizeof(T));
+
+    switch (start) {
+    case tier::small:
+    case tier::pattern:
+        note_tier(start);
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        return;
+    case tier::direct_counting:
+        if constexpr (is_direct_countable_v<T>) {
+            direct_counting_sort<T, Descending>(arr, n);
+            return;
+        }
+        break;
+    case tier::dense:
+        if constexpr (has_dense_tier_v<T>) {
+            auto body = [arr, n](auto& hist) { counting_sort<T, Descending>(arr, n, hist); };
+            if (with_dense_histogram(arr, n, body, nullptr, &range)) {
+                return;
+            }
+        }
+        [[fallthrough]];
+    case tier::few_distinct:
+        if (few_distinct_sort<T, Descending>(arr, n)) {
+            return;
+        }
+        [[fallthrough]];
+    case tier::heavy_hitters:
+        if (heavy_hitter_sort<T, Descending>(arr, n, nullptr)) {
+            return;
+        }
+        [[fallthrough]];
+    case tier::radix: {
+        temp_buffer<T> temp(nullptr, n);
+        radix_sort<T, Descending>(arr, n, temp.data());
+        return;
+    }
+    default:
+        break;
+    }
+    tieredsort_alloc_impl<T, Descending>(arr, n);
+}
+
+// Worst-case heap bytes of the dense tier's histogram for n elements: the
+// sampled window (at most n + 2 * slack buckets, capped at 2n) plus, if a
+// block falls outside it, the exact-range table (at most 2n) built while
+// the first is still live
+inline size_t dense_histogram_bytes(size_t n) {
+    size_t counter = n <= std::numeric_limits<uint32_t>::max() ? sizeof(uint32_t) : sizeof(size_t);
+    size_t first = std::min(2 * n, n + 2 * (n / 8 + 64));
+    return (first + 2 * n) * counter;
+}
+
+// =============================================================================
+// STABLE TIEREDSORT IMPLEMENTATION
+// =============================================================================
+
+// Stable version for integral types
+template<typename T, bool Descending = false>
+typename std::enable_if_t<std::is_integral_v<T> && !is_int128_v<T>>
+tieredsort_stable_impl(T* arr, size_t n, T* temp, workspace* ws = nullptr) {
+    stats_scope stats(n, sizeof(T));
+
+    // Tier 1: Small arrays - std::stable_sort (buffered with a workspace)
+    if (n < 256) {
+        note_tier(tier::small);
+        stable_sort_small(arr, n, temp, ws, order_compare<T, Descending>());
+        return;
+    }
+
+    // 8/16-bit types: always dense - count the full value space directly
+    if constexpr (is_direct_countable_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            direct_counting_sort<T, Descending>(arr, n, ws);
+            return;
+        }
+    }
+
+    // Tier 2: Pattern detection - stable merge sort is O(n) on sorted input
+    if (is_pattern_sorted(arr, n)) {
+        note_tier(tier::pattern);
+        stable_sort_small(arr, n, temp, ws, order_compare<T, Descending>());
+        return;
+    }
+
+    // Tier 3: Dense range detection - use stable counting sort
+    auto stable_count = [arr, n, temp](auto& hist) {
+        counting_sort_stable<T, Descending>(arr, n, hist, temp);
+    };
+    if (with_dense_histogram(arr, n, stable_count, ws)) {
+        return;
+    }
+
+    // Tier 3b: Few distinct values anywhere in the key space - count them
+    if (few_distinct_sort<T, Descending>(arr, n)) {
+        return;
+    }
+
+    // Tier 3c: Heavy hitters - count them, radix sort only the tail
+    if (heavy_hitter_sort<T, Descending>(arr, n, temp)) {
+        return;
+    }
+
+    // Tier 4: Radix sort (already stable due to backwards iteration)
+    radix_sort<T, Descending>(arr, n, temp);
+}
+
+// Stable version for floating point types and 128-bit integers
+template<typename T, bool Descending = false>
+typename std::enable_if_t<std::is_floating_point_v<T> || is_half_float_v<T> || is_int128_v<T>>
+tieredsort_stable_impl(T* arr, size_t n, T* temp, workspace* ws = nullptr) {
+    stats_scope stats(n, sizeof(T));
+
+    // Tier 1: Small arrays
+    if (n < 256) {
+        note_tier(tier::small);
+        stable_sort_small(arr, n, temp, ws, order_compare<T, Descending>());
+        return;
+    }
+
+    // 16-bit floats: 65536 bit patterns - count them directly
+    if constexpr (is_half_float_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            direct_counting_sort<T, Descending>(arr, n, ws);
+            return;
+        }
+    }
+
+    // Tier 2: Pattern detection
+    if (is_pattern_sorted(arr, n)) {
+        note_tier(tier::pattern);
+        stable_sort_small(arr, n, temp, ws, order_compare<T, Descending>());
+        return;
+    }
+
+    // Tier 3: Dense range of whole numbers (float and double only)
+    if constexpr (has_dense_tier_v<T>) {
+        auto stable_count = [arr, n, temp](auto& hist) {
+            counting_sort_stable<T, Descending>(arr, n, hist, temp);
+        };
+        if (with_dense_histogram(arr, n, stable_count, ws)) {
+            return;
+        }
+    }
+
+    // Tier 3b: Few distinct values anywhere in the key space - count them
+    if (few_distinct_sort<T, Descending>(arr, n)) {
+        return;
+    }
+
+    // Tier 3c: Heavy hitters - count them, radix sort only the tail
+    if (heavy_hitter_sort<T, Descending>(arr, n, temp)) {
+        return;
+    }
+
+    // Tier 4: Radix sort (already stable)
+    radix_sort<T, Descending>(arr, n, temp);
+}
+
+// Stable tiers with the temp buffer allocated only past the pattern check
+// (from the workspace, if given)
+template<typename T, bool Descending = false>
+void tieredsort_stable_alloc_impl(T* arr, size_t n, workspace* ws = nullptr) {
+    stats_scope stats(n, sizeof(T));
+
+    // Tier 1: Small arrays - std::stable_sort (buffered with a workspace)
+    if (n < 256) {
+        note_tier(tier::small);
+        stable_sort_small(arr, n, static_cast<T*>(nullptr), ws, order_compare<T, Descending>());
+        return;
+    }
+
+    // 8/16-bit types: always dense - count the full value space directly
+    if constexpr (is_direct_countable_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            direct_counting_sort<T, Descending>(arr, n, ws);
+            return;
+        }
+    }
+
+    // Tier 2: Pattern detection - stable merge sort is O(n) on sorted input
+    if (is_pattern_sorted(arr, n)) {
+        note_tier(tier::pattern);
+        stable_sort_small(arr, n, static_cast<T*>(nullptr), ws, order_compare<T, Descending>());
+        return;
+    }
+
+    // Tier 3: Dense range - the stable counting sort needs the temp buffer
+    if constexpr (has_dense_tier_v<T>) {
+        auto stable_count = [arr, n, ws](auto& hist) {
+            temp_buffer<T> temp(ws, n);
+            counting_sort_stable<T, Descending>(arr, n, hist, temp.data());
+        };
+        if (with_dense_histogram(arr, n, stable_count, ws)) {
+            return;
+        }
+    }
+
+    // Tier 3b: Few distinct values anywhere in the key space - count them
+    if (few_distinct_sort<T, Descending>(arr, n)) {
+        return;
+    }
+
+    // Tier 3c: Heavy hitters - count them, radix sort only the tail
+    if (heavy_hitter_sort<T, Descending>(arr, n, nullptr, ws)) {
+        return;
+    }
+
+    // Tier 4: Radix sort - only NOW allocate
+    temp_buffer<T> temp(ws, n);
+    radix_sort<T, Descending>(arr, n, temp.data());
+}
+
+} // namespace detail
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+/**
+ * Sort direction. Descending is folded into the key transform of the
+ * radix and counting tiers, so it costs the same as ascending.
+ */
+enum class sort_order { ascending, descending };
+
+/**
+ * Sort a range of elements using tieredsort.
+ *
+ * Supported types: int8_t, uint8_t, int16_t, uint16_t, char types,
+ *                  int32_t, uint32_t, int64_t, uint64_t, float, double,
+ *                  __int128 and unsigned __int128 (where available),
+ *                  _Float16, __bf16 (where available) and tiered::bfloat16
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param order Sort direction (ascending by default)
+ */
+template<typename RandomIt>
+void sort(RandomIt first, RandomIt last, sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    T* arr = &(*first);
+    if (order == sort_order::descending) {
+        detail::tieredsort_alloc_impl<T, true>(arr, n);
+    } else {
+        detail::tieredsort_alloc_impl<T, false>(arr, n);
+    }
+}
+
+/**
+ * Sort a range using a provided buffer (avoids allocation).
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param buffer Temporary buffer of at least (last - first) elements
+ * @param order Sort direction (ascending by default)
+ */
+template<typename RandomIt>
+void sort(RandomIt first, RandomIt last, typename std::iterator_traits<RandomIt>::value_type* buffer,
+          sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    T* arr = &(*first);
+    if (order == sort_order::descending) {
+        detail::tieredsort_impl<T, true>(arr, n, buffer);
+    } else {
+        detail::tieredsort_impl<T, false>(arr, n, buffer);
+    }
+}
+
+/**
+ * Stable sort a range of primitive elements using tieredsort.
+ *
+ * NOTE: For primitive types (integers, floats), stability is technically
+ * maintained but is NOT OBSERVABLE - equal values are indistinguishable,
+ * so the stable/unstable versions produce identical output.
+ *
+ * For sorting objects/structs by a key with observable stability,
+ * use tiered::sort_by_key() instead.
+ *
+ * Supported types: int8_t, uint8_t, int16_t, uint16_t, char types,
+ *                  int32_t, uint32_t, int64_t, uint64_t, float, double,
+ *                  __int128 and unsigned __int128 (where available),
+ *                  _Float16, __bf16 (where available) and tiered::bfloat16
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param order Sort direction (ascending by default)
+ */
+template<typename RandomIt>
+void stable_sort(RandomIt first, RandomIt last, sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    T* arr = &(*first);
+    if (order == sort_order::descending) {
+        detail::tieredsort_stable_alloc_impl<T, true>(arr, n);
+    } else {
+        detail::tieredsort_stable_alloc_impl<T, false>(arr, n);
+    }
+}
+
+/**
+ * Stable sort a range using a provided buffer (avoids allocation).
+ *
+ * See stable_sort() note: for primitives, stability is not observable.
+ * Use tiered::sort_by_key() for objects with meaningful stability.
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param buffer Temporary buffer of at least (last - first) elements
+ * @param order Sort direction (ascending by default)
+ */
+template<typename RandomIt>
+void stable_sort(RandomIt first, RandomIt last, typename std::iterator_traits<RandomIt>::value_type* buffer,
+                 sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    T* arr = &(*first);
+    if (order == sort_order::descending) {
+        detail::tieredsort_stable_impl<T, true>(arr, n, buffer);
+    } else {
+        detail::tieredsort_stable_impl<T, false>(arr, n, buffer);
+    }
+}
+
+// =============================================================================
+// KEY-BASED SORTING (for objects with integer keys)
+// =============================================================================
+
+namespace detail {
+
+// Radix sort for 64-bit (key << 32 | index) pairs - stable
+inline void radix_sort_64_stable(uint64_t* arr, size_t n, uint64_t* temp) {
+    uint64_t* src = arr;
+    uint64_t* dst = temp;
+
+    int count[256];
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        std::memset(count, 0, sizeof(count));
+
+        for (size_t i = 0; i < n; i++) {
+            count[(src[i] >> shift) & 0xFF]++;
+        }
+
+        for (int i = 1; i < 256; i++) {
+            count[i] += count[i - 1];
+        }
+
+        // Backwards iteration for stability
+        for (size_t i = n; i-- > 0;) {
+            dst[--count[(src[i] >> shift) & 0xFF]] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    // Ensure result is in arr
+    if (src != arr) {
+        std::memcpy(arr, src, n * sizeof(uint64_t));
+    }
+}
+
+// Apply permutation - move objects according to sorted indices
+template<typename T>
+void apply_permutation(T* items, const uint32_t* perm, size_t n, T* temp) {
+    for (size_t i = 0; i < n; i++) {
+        temp[i] = std::move(items[perm[i]]);
+    }
+    for (size_t i = 0; i < n; i++) {
+        items[i] = std::move(temp[i]);
+    }
+}
+
+// Pattern detection for keys
+inline bool is_pattern_sorted_keys(const int32_t* keys, size_t n) {
+    if (n < 8) return true;
+
+    size_t m = n / 2;
+
+    bool head_asc = keys[0] <= keys[1] && keys[1] <= keys[2] && keys[2] <= keys[3];
+    bool head_desc = keys[0] >= keys[1] && keys[1] >= keys[2] && keys[2] >= keys[3];
+    if (!head_asc && !head_desc) return false;
+
+    bool mid_asc = keys[m-1] <= keys[m] && keys[m] <= keys[m+1] && keys[m+1] <= keys[m+2];
+    bool mid_desc = keys[m-1] >= keys[m] && keys[m] >= keys[m+1] && keys[m+1] >= keys[m+2];
+    if (!mid_asc && !mid_desc) return false;
+
+    bool tail_asc = keys[n-4] <= keys[n-3] && keys[n-3] <= keys[n-2] && keys[n-2] <= keys[n-1];
+    bool tail_desc = keys[n-4] >= keys[n-3] && keys[n-3] >= keys[n-2] && keys[n-2] >= keys[n-1];
+    if (!tail_asc && !tail_desc) return false;
+
+    return true;
+}
+
+// Counting sort directly on objects - stable, O(n + range)
+// Much faster than radix sort for dense key ranges
+template<bool Descending, typename T, typename KeyFunc>
+void counting_sort_objects_stable(T* items, size_t n, KeyFunc key_func,
+                                   int32_t min_key, int32_t max_key, T* temp,
+                                   workspace* ws = nullptr) {
+    size_t range = static_cast<size_t>(max_key - min_key + 1);
+    count_table<size_t> count(ws, workspace::COUNTS, range);
+
+    // Count occurrences
+    for (size_t i = 0; i < n; i++) {
+        int32_t k = key_func(items[i]);
+        count[static_cast<size_t>(k - min_key)]++;
+    }
+
+    // Prefix sum (suffix sum for descending)
+    if constexpr (Descending) {
+        for (size_t i = range - 1; i-- > 0;) {
+            count[i] += count[i + 1];
+        }
+    } else {
+        for (size_t i = 1; i < range; i++) {
+            count[i] += count[i - 1];
+        }
+    }
+
+    // Place objects in stable order (backwards iteration)
+    for (size_t i = n; i-- > 0;) {
+        int32_t k = key_func(items[i]);
+        size_t idx = static_cast<size_t>(k - min_key);
+        temp[--count[idx]] = std::move(items[i]);
+    }
+
+    // Move back
+    for (size_t i = 0; i < n; i++) {
+        items[i] = std::move(temp[i]);
+    }
+}
+
+// Dense range detection for key-based sorting
+template<typename RandomIt, typename KeyFunc>
+bool detect_dense_range_for_keys(RandomIt first, size_t n, KeyFunc key_func,
+                                  int32_t& out_min, int32_t& out_max) {
+    int32_t min_val = key_func(*first);
+    int32_t max_val = min_val;
+
+    // Sample (stratified, jittered)
+    size_t samples = std::min(n, DENSE_SAMPLE_SIZE);
+    for (size_t j = 0; j < samples; j++) {
+        int32_t k = key_func(*(first + sample_index(j, samples, n)));
+        if (k < min_val) min_val = k;
+        if (k > max_val) max_val = k;
+    }
+
+    const int64_t limit = static_cast<int64_t>(n) * 2;
+    int64_t range_est = static_cast<int64_t>(max_val) - static_cast<int64_t>(min_val) + 1;
+    if (range_est > limit) {
+        return false;
+    }
+
+    // Full scan for exact bounds, abandoned once the range exceeds 2n
+    for (size_t start = 0; start < n; start += DENSE_SCAN_BLOCK) {
+        size_t end = std::min(n, start + DENSE_SCAN_BLOCK);
+        for (size_t i = start; i < end; i++) {
+            int32_t k = key_func(*(first + i));
+            if (k < min_val) min_val = k;
+            if (k > max_val) max_val = k;
+        }
+        if (static_cast<int64_t>(max_val) - static_cast<int64_t>(min_val) + 1 > limit) {
+            return false;
+        }
+    }
+
+    out_min = min_val;
+    out_max = max_val;
+    return true;
+}
+
+// Exact key bounds for 8/16-bit keys (a full scan, no sampling).
+// 8-bit keys just use the full type range: 256 counters cost less than a scan.
+template<typename KeyType, typename RandomIt, typename KeyFunc>
+void small_key_bounds(RandomIt first, size_t n, KeyFunc key_func,
+                      int32_t& out_min, int32_t& out_max) {
+    if constexpr (sizeof(KeyType) == 1) {
+        (void)first; (void)n; (void)key_func;
+        out_min = std::numeric_limits<KeyType>::min();
+        out_max = std::numeric_limits<KeyType>::max();
+    } else {
+        int32_t min_val = key_func(*first);
+        int32_t max_val = min_val;
+        for (size_t i = 1; i < n; i++) {
+            int32_t k = key_func(*(first + i));
+            if (k < min_val) min_val = k;
+            if (k > max_val) max_val = k;
+        }
+        out_min = min_val;
+        out_max = max_val;
+    }
+}
+
+// Pattern detection for key-based sorting
+template<typename RandomIt, typename KeyFunc>
+bool is_pattern_sorted_for_keys(RandomIt first, size_t n, KeyFunc key_func) {
+    if (n < 8) return true;
+
+    size_t m = n / 2;
+
+    auto k0 = key_func(*(first));
+    auto k1 = key_func(*(first + 1));
+    auto k2 = key_func(*(first + 2));
+    auto k3 = key_func(*(first + 3));
+
+    bool head_asc = k0 <= k1 && k1 <= k2 && k2 <= k3;
+    bool head_desc = k0 >= k1 && k1 >= k2 && k2 >= k3;
+    if (!head_asc && !head_desc) return false;
+
+    auto km1 = key_func(*(first + m - 1));
+    auto km0 = key_func(*(first + m));
+    auto kmp1 = key_func(*(first + m + 1));
+    auto kmp2 = key_func(*(first + m + 2));
+
+    bool mid_asc = km1 <= km0 && km0 <= kmp1 && kmp1 <= kmp2;
+    bool mid_desc = km1 >= km0 && km0 >= kmp1 && kmp1 >= kmp2;
+    if (!mid_asc && !mid_desc) return false;
+
+    auto kn4 = key_func(*(first + n - 4));
+    auto kn3 = key_func(*(first + n - 3));
+    auto kn2 = key_func(*(first + n - 2));
+    auto kn1 = key_func(*(first + n - 1));
+
+    bool tail_asc = kn4 <= kn3 && kn3 <= kn2 && kn2 <= kn1;
+    bool tail_desc = kn4 >= kn3 && kn3 >= kn2 && kn2 >= kn1;
+    if (!tail_asc && !tail_desc) return false;
+
+    return true;
+}
+
+} // namespace detail (key-based sorting helpers)
+
+namespace detail {
+
+// `objects` and `ws` (from tiered::sorter or a memory_resource overload)
+// supply the object buffer and count table; without them each call
+// allocates its own
+template<bool Descending, typename RandomIt, typename KeyFunc,
+         typename Objects = std::vector<typename std::iterator_traits<RandomIt>::value_type>>
+void sort_by_key_impl(RandomIt first, RandomIt last, KeyFunc key_func,
+                      Objects* objects = nullptr, workspace* ws = nullptr) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using KeyType = std::invoke_result_t<KeyFunc, const T&>;
+
+    size_t n = std::distance(first, last);
+    T* items = &(*first);
+    stats_scope stats(n, sizeof(T));
+
+    auto key_compare = [&key_func](const T& a, const T& b) {
+        if constexpr (Descending) {
+            return key_func(b) < key_func(a);
+        } else {
+            return key_func(a) < key_func(b);
+        }
+    };
+
+    Objects local;
+    auto temp_objects = [&]() -> T* {
+        Objects& buf = objects ? *objects : local;
+        if (buf.size() < n) {
+            note_alloc(n * sizeof(T));
+            buf.resize(n);
+        }
+        return buf.data();
+    };
+    auto stable_fallback = [&] {
+        if (objects) {
+            stable_sort_buffered(items, n, temp_objects(), key_compare);
+        } else {
+            std::stable_sort(first, last, key_compare);
+        }
+    };
+
+    // Tier 1: Small arrays - std::stable_sort wins
+    if (n < 256) {
+        note_tier(tier::small);
+        stable_fallback();
+        return;
+    }
+
+    // Tier 2: Pattern detection - std::stable_sort is O(n) for sorted/reversed
+    if (is_pattern_sorted_for_keys(first, n, key_func)) {
+        note_tier(tier::pattern);
+        stable_fallback();
+        return;
+    }
+
+    // 8/16-bit keys: exact bounds without sampling. Counted only when the
+    // range is dense for n (the dense tier's 2n limit), so a few hundred
+    // keys spread over 16 bits do not zero and walk 65536 counters.
+    int32_t min_key, max_key;
+    if constexpr (is_small_int_v<KeyType>) {
+        small_key_bounds<KeyType>(first, n, key_func, min_key, max_key);
+        int64_t range = static_cast<int64_t>(max_key) - static_cast<int64_t>(min_key) + 1;
+        if (range <= static_cast<int64_t>(n) * 2) {
+            note_tier(tier::direct_counting);
+            counting_sort_objects_stable<Descending>(items, n, key_func, min_key, max_key, temp_objects(), ws);
+        } else {
+            note_tier(tier::comparison);
+            stable_fallback();
+        }
+        return;
+    }
+
+    // Tier 3: Dense range - counting sort directly on objects (3-5x faster!)
+    if (detect_dense_range_for_keys(first, n, key_func, min_key, max_key)) {
+        note_tier(tier::dense);
+        note_dense_bounds(to_unsigned(min_key), to_unsigned(max_key));
+        counting_sort_objects_stable<Descending>(items, n, key_func, min_key, max_key, temp_objects(), ws);
+        return;
+    }
+
+    // Tier 4: Sparse range - std::stable_sort is highly optimized
+    note_tier(tier::comparison);
+    stable_fallback();
+}
+
+} // namespace detail
+
+/**
+ * Sort objects by an integer key (8, 16 or 32 bits) using tieredsort's fast algorithms.
+ *
+ * This is a STABLE sort - objects with equal keys maintain their relative order.
+ * Unlike primitive sorting where stability is unobservable, key-based sorting
+ * on objects has meaningful, verifiable stability.
+ *
+ * Performance: 3-5x faster than std::stable_sort for dense key ranges
+ * (ages, scores, sensor data). Falls back to std::stable_sort for sparse keys.
+ *
+ * @param first Iterator to beginning
+ * @param last Iterator to end
+ * @param key_func Function that extracts the key from an object. Must return
+ *                 int32_t, uint32_t or an 8/16-bit integer type (8/16-bit
+ *                 keys skip sampling and are counted when their range is
+ *                 at most 2n)
+ * @param order Sort direction (ascending by default). Descending keeps equal
+ *              keys in their original order, so no key negation is needed.
+ *
+ * Example:
+ *   struct Person { std::string name; int age; };
+ *   std::vector<Person> people = {...};
+ *   tiered::sort_by_key(people.begin(), people.end(),
+ *                       [](const Person& p) { return p.age; });
+ */
+template<typename RandomIt, typename KeyFunc>
+void sort_by_key(RandomIt first, RandomIt last, KeyFunc key_func,
+                 sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using KeyType = std::invoke_result_t<KeyFunc, const T&>;
+
+    static_assert(detail::is_small_int_v<KeyType> ||
+                  std::is_same_v<KeyType, int32_t> ||
+                  std::is_same_v<KeyType, uint32_t>,
+                  "Key function must return an 8/16-bit integer, int32_t or uint32_t");
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    if (order == sort_order::descending) {
+        detail::sort_by_key_impl<true>(first, last, key_func);
+    } else {
+        detail::sort_by_key_impl<false>(first, last, key_func);
+    }
+}
+
+// =============================================================================
+// REUSABLE SORTER (scratch memory kept across calls)
+// =============================================================================
+
+/**
+ * Sorter that owns its scratch memory across calls.
+ *
+ * The temp buffer, counting tables and histograms are taken only when a
+ * tier needs them, grow to the largest input seen and are then reused, so
+ * once warmed up, sort(), stable_sort() and sort_by_key() make no heap
+ * allocations on any tier. Not thread-safe:
+ * use one sorter per thread.
+ *
+ * Example:
+ *   tiered::sorter<uint32_t> s;
+ *   for (auto& batch : batches) s.sort(batch.begin(), batch.end());
+ */
 template<typename T>
-typename std::enable_if_t<std::is_integral_v<T>>
-tieredsort_impl(T* arr, size_t n, T* temp) {
-    // Tier 1: Small arrays - use std::sort
+class sorter {
+public:
+#ifdef TIEREDSORT_HAS_PMR
+    sorter() : sorter(std::pmr::new_delete_resource()) {}
+
+    /**
+     * Sorter whose scratch memory (temp buffer, tables, sort_by_key's
+     * object buffer) comes from `resource`, e.g. a per-thread pool.
+     */
+    explicit sorter(std::pmr::memory_resource* resource) : ws_(resource), objects_(resource) {}
+#else
+    sorter() = default;
+#endif
+
+    /**
+     * Same result as tiered::sort().
+     */
+    template<typename RandomIt>
+    void sort(RandomIt first, RandomIt last, sort_order order = sort_order::ascending) {
+        static_assert(std::is_same_v<typename std::iterator_traits<RandomIt>::value_type, T>,
+                      "sorter<T> sorts ranges of T");
+        static_assert(
+            detail::is_sortable_v<T>,
+            "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+            "float, double, 16-bit floats and 128-bit integers"
+        );
+
+        size_t n = std::distance(first, last);
+        if (n <= 1) return;
+
+        T* arr = &(*first);
+        if (order == sort_order::descending) {
+            detail::tieredsort_alloc_impl<T, true>(arr, n, &ws_);
+        } else {
+            detail::tieredsort_alloc_impl<T, false>(arr, n, &ws_);
+        }
+    }
+
+    /**
+     * Same result as tiered::stable_sort().
+     */
+    template<typename RandomIt>
+    void stable_sort(RandomIt first, RandomIt last, sort_order order = sort_order::ascending) {
+        static_assert(std::is_same_v<typename std::iterator_traits<RandomIt>::value_type, T>,
+                      "sorter<T> sorts ranges of T");
+        static_assert(
+            detail::is_sortable_v<T>,
+            "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+            "float, double, 16-bit floats and 128-bit integers"
+        );
+
+        size_t n = std::distance(first, last);
+        if (n <= 1) return;
+
+        T* arr = &(*first);
+        if (order == sort_order::descending) {
+            detail::tieredsort_stable_alloc_impl<T, true>(arr, n, &ws_);
+        } else {
+            detail::tieredsort_stable_alloc_impl<T, false>(arr, n, &ws_);
+        }
+    }
+
+    /**
+     * Same result as tiered::sort_by_key() on a range of T objects.
+     */
+    template<typename RandomIt, typename KeyFunc>
+    void sort_by_key(RandomIt first, RandomIt last, KeyFunc key_func,
+                     sort_order order = sort_order::ascending) {
+        static_assert(std::is_same_v<typename std::iterator_traits<RandomIt>::value_type, T>,
+                      "sorter<T> sorts ranges of T");
+        using KeyType = std::invoke_result_t<KeyFunc, const T&>;
+        static_assert(detail::is_small_int_v<KeyType> ||
+                      std::is_same_v<KeyType, int32_t> ||
+                      std::is_same_v<KeyType, uint32_t>,
+                      "Key function must return an 8/16-bit integer, int32_t or uint32_t");
+
+        size_t n = std::distance(first, last);
+        if (n <= 1) return;
+
+        if (order == sort_order::descending) {
+            detail::sort_by_key_impl<true>(first, last, key_func, &objects_, &ws_);
+        } else {
+            detail::sort_by_key_impl<false>(first, last, key_func, &objects_, &ws_);
+        }
+    }
+
+    /** Free all scratch memory (it grows again on the next call). */
+    void release() {
+        ws_.release();
+        objects_.clear();
+        objects_.shrink_to_fit();
+    }
+
+private:
+#ifdef TIEREDSORT_HAS_PMR
+    using object_buffer = std::pmr::vector<T>;
+#else
+    using object_buffer = std::vector<T>;
+#endif
+
+    detail::workspace ws_;
+    object_buffer objects_;   // sort_by_key's object buffer
+};
+
+#ifdef TIEREDSORT_HAS_PMR
+
+// =============================================================================
+// MEMORY RESOURCE OVERLOADS (std::pmr)
+// =============================================================================
+
+/**
+ * tiered::sort() with all scratch memory (radix temp buffer, counting
+ * tables) taken from `resource`, e.g. a per-request
+ * std::pmr::monotonic_buffer_resource or a huge-page pool. Nothing is
+ * allocated from the global heap; tiers that need no scratch allocate
+ * nothing.
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param resource Memory resource for scratch allocations (not null)
+ * @param order Sort direction (ascending by default)
+ */
+template<typename RandomIt>
+void sort(RandomIt first, RandomIt last, std::pmr::memory_resource* resource,
+          sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    T* arr = &(*first);
+    detail::workspace ws(resource);
+    if (order == sort_order::descending) {
+        detail::tieredsort_alloc_impl<T, true>(arr, n, &ws);
+    } else {
+        detail::tieredsort_alloc_impl<T, false>(arr, n, &ws);
+    }
+}
+
+/**
+ * tiered::stable_sort() with all scratch memory taken from `resource`.
+ * The small and patterned tiers use a buffered merge sort instead of
+ * std::stable_sort, which would allocate from the global heap.
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param resource Memory resource for scratch allocations (not null)
+ * @param order Sort direction (ascending by default)
+ */
+template<typename RandomIt>
+void stable_sort(RandomIt first, RandomIt last, std::pmr::memory_resource* resource,
+                 sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    T* arr = &(*first);
+    detail::workspace ws(resource);
+    if (order == sort_order::descending) {
+        detail::tieredsort_stable_alloc_impl<T, true>(arr, n, &ws);
+    } else {
+        detail::tieredsort_stable_alloc_impl<T, false>(arr, n, &ws);
+    }
+}
+
+/**
+ * tiered::sort_by_key() with the object buffer and counting table taken
+ * from `resource`. Only the elements' own copy/move operations may still
+ * allocate (e.g. std::string members).
+ *
+ * @param first Iterator to beginning
+ * @param last Iterator to end
+ * @param key_func Function that extracts the key from an object (8/16-bit
+ *                 integer, int32_t or uint32_t)
+ * @param resource Memory resource for scratch allocations (not null)
+ * @param order Sort direction (ascending by default)
+ */
+template<typename RandomIt, typename KeyFunc>
+void sort_by_key(RandomIt first, RandomIt last, KeyFunc key_func, std::pmr::memory_resource* resource,
+                 sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using KeyType = std::invoke_result_t<KeyFunc, const T&>;
+
+    static_assert(detail::is_small_int_v<KeyType> ||
+                  std::is_same_v<KeyType, int32_t> ||
+                  std::is_same_v<KeyType, uint32_t>,
+                  "Key function must return an 8/16-bit integer, int32_t or uint32_t");
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    std::pmr::vector<T> objects(resource);
+    detail::workspace ws(resource);
+    if (order == sort_order::descending) {
+        detail::sort_by_key_impl<true>(first, last, key_func, &objects, &ws);
+    } else {
+        detail::sort_by_key_impl<false>(first, last, key_func, &objects, &ws);
+    }
+}
+
+#endif // TIEREDSORT_HAS_PMR
+
+// =============================================================================
+// BOUNDED-MEMORY SORTING
+// =============================================================================
+
+/**
+ * Which operation scratch_bytes_required() sizes.
+ */
+enum class scratch_mode { sort, stable_sort, sort_by_key };
+
+/**
+ * Peak scratch memory, in bytes, that tiered::sort(), stable_sort() or
+ * sort_by_key() may allocate for n elements of T, over all inputs (for
+ * sort_by_key, T is the object type). The dense tier dominates for small
+ * element types: its histogram holds up to 2n counters, twice over while
+ * it rebases. sort_bounded() given this many bytes never leaves its
+ * preferred tier.
+ *
+ * @param n Number of elements
+ * @param mode Operation to size (tiered::sort by default)
+ */
+template<typename T>
+size_t scratch_bytes_required(size_t n, scratch_mode mode = scratch_mode::sort) {
+    constexpr size_t pad = alignof(std::max_align_t);   // arena alignment, per block
+    if (n <= 1) return 0;
+
+    // sort_by_key: object buffer plus a size_t count per key in the range
+    // (counted only up to 2n keys, whatever the key width). Object types
+    // have no other mode.
+    size_t keyed = n * sizeof(T) + 2 * n * sizeof(size_t) + 2 * pad;
+    if constexpr (!detail::is_sortable_v<T>) {
+        (void)mode;
+        return keyed;
+    } else {
+        if (mode == scratch_mode::sort_by_key) return keyed;
+
+        const bool stable = mode == scratch_mode::stable_sort;
+        const size_t buffer = n * sizeof(T) + pad;
+
+        // Comparison tiers: std::stable_sort takes a buffer, std::sort none
+        if (n < 256) return stable ? buffer : 0;
+
+        // 8-bit arrays, and 16-bit ones from 65536 elements, only count
+        if (detail::use_direct_counting<T>(n)) {
+            size_t bytes = detail::direct_counting_bytes<T>(n);
+            return bytes ? bytes + pad : 0;
+        }
+
+        // Radix temp buffer (the heavy-hitter tail needs less)
+        size_t peak = buffer;
+        if constexpr (detail::has_dense_tier_v<T>) {
+            size_t dense = detail::dense_histogram_bytes(n) + 2 * pad;
+            peak = std::max(peak, stable ? dense + buffer : dense);
+        }
+        return peak;
+    }
+}
+
+/**
+ * Sort a range using only `buffer_bytes` bytes of scratch at `buffer`;
+ * never allocates. Same result as tiered::sort(). Tiers that need more
+ * than the budget are skipped: the dense tier gives up if its histogram
+ * does not fit, and without room for the radix temp buffer (n elements)
+ * an in-place MSD radix sort (American flag sort) is used instead. With
+ * scratch_bytes_required<T>(n) bytes every input takes its usual tier.
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param buffer Scratch memory (any alignment; may be null if buffer_bytes is 0)
+ * @param buffer_bytes Size of the scratch memory in bytes
+ * @param order Sort direction (ascending by default)
+ *
+ * Example:
+ *   static unsigned char scratch[1 << 20];   // 1 MB cap, however large the input
+ *   tiered::sort_bounded(data.begin(), data.end(), scratch, sizeof(scratch));
+ */
+template<typename RandomIt>
+void sort_bounded(RandomIt first, RandomIt last, void* buffer, size_t buffer_bytes,
+                  sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    T* arr = &(*first);
+    detail::workspace ws(buffer, buffer ? buffer_bytes : 0);
+    if (order == sort_order::descending) {
+        detail::tieredsort_bounded_impl<T, true>(arr, n, ws);
+    } else {
+        detail::tieredsort_bounded_impl<T, false>(arr, n, ws);
+    }
+}
+
+// =============================================================================
+// SORT PLANNING (dry run)
+// =============================================================================
+
+/**
+ * What tiered::sort() would do with a range, found by running only its
+ * detection checks. Costs are estimates in element operations (n per pass
+ * over the data, n log2 n for a comparison sort, plus histogram buckets):
+ * they rank plans against each other, they are not a time.
+ */
+struct sort_plan {
+    tier chosen = tier::small;     // tier the sort would take
+    size_t n = 0;
+    size_t element_bytes = 0;
+    sort_order order = sort_order::ascending;
+
+    unsigned passes = 0;           // sorting passes (radix digits, count + write, comparison levels)
+    size_t scratch_bytes = 0;      // heap the sort would allocate, at most
+    uint64_t cost = 0;             // estimated element operations
+
+    uint64_t min_key = 0;          // exact dense key bounds (dense tier only)
+    uint64_t max_key = 0;
+};
+
+namespace detail {
+
+// Comparison levels of a sort of n elements: ceil(log2 n)
+inline unsigned comparison_levels(size_t n) {
+    unsigned levels = 0;
+    while (levels < 63 && (size_t(1) << levels) < n) levels++;
+    return levels;
+}
+
+// The detection steps of tieredsort_alloc_impl, in its order, stopping at
+// the first tier that accepts. The dense tier's bounds are scanned exactly
+// (one read of the data); the few-distinct and heavy-hitter tiers are
+// judged on their samples alone.
+template<typename T>
+void plan_tiers(const T* arr, size_t n, sort_plan& p) {
+    using K = decltype(to_unsigned(std::declval<T>()));
+    const uint64_t elements = n;
+    auto compare = [&p, elements, n](tier t) {
+        p.chosen = t;
+        p.passes = comparison_levels(n);
+        p.cost = elements * p.passes;
+    };
+
+    if (n < 256) {
+        compare(tier::small);
+        return;
+    }
+
+    if constexpr (is_direct_countable_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            p.chosen = tier::direct_counting;
+            p.passes = 2;
+            p.scratch_bytes = direct_counting_bytes<T>(n);
+            p.cost = 2 * elements + (uint64_t(1) << (sizeof(T) * 8));
+            return;
+        }
+    }
+
+    if (is_pattern_sorted(arr, n)) {
+        compare(tier::pattern);
+        return;
+    }
+
+    if constexpr (has_dense_tier_v<T>) {
+        key_range range;
+        if (scan_dense_range<dense_keys_t<T>>(arr, n, range)) {
+            size_t buckets = static_cast<size_t>(range.max_key - range.min_key + 1);
+            size_t counter = n <= std::numeric_limits<uint32_t>::max() ? sizeof(uint32_t) : sizeof(size_t);
+            p.chosen = tier::dense;
+            p.passes = 2;
+            p.scratch_bytes = buckets > DENSE_STACK_BUCKETS ? buckets * counter : 0;
+            p.cost = 2 * elements + buckets;
+            p.min_key = range.min_key;
+            p.max_key = range.max_key;
+            return;
+        }
+    }
+
+    {
+        distinct_table<K> table;
+        if (sample_few_distinct(arr, n, table)) {
+            p.chosen = tier::few_distinct;
+            p.passes = 2;
+            p.cost = 2 * elements;
+            return;
+        }
+    }
+
+    // Both remaining tiers need a radix temp buffer of up to n elements
+    const unsigned digits = static_cast<unsigned>(sizeof(K));
+    p.scratch_bytes = n * sizeof(T);
+
+    if (n >= SKEW_MIN_N) {
+        distinct_table<K> heavy;
+        size_t covered = 0;
+        if (detect_heavy_hitters(arr, n, heavy, &covered)) {
+            // Count + compact, radix sort the sampled tail share, splice
+            uint64_t tail = elements - elements * covered / SKEW_SAMPLE;
+            p.chosen = tier::heavy_hitters;
+            p.passes = digits + 2;
+            p.cost = 2 * elements + tail * digits;
+            return;
+        }
+    }
+
+    p.chosen = tier::radix;
+    p.passes = digits;
+    p.cost = elements * digits;
+}
+
+} // namespace detail
+
+/**
+ * Run only the detection logic of tiered::sort() on a range: pattern
+ * check, dense range (sample, then one scan for the exact bounds) and the
+ * few-distinct and heavy-hitter samples. Nothing is moved or allocated.
+ * Hand the plan to tiered::execute() to sort without detecting again.
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param order Sort direction execute() will use (ascending by default)
+ * @return Tier, estimated passes, scratch bytes and cost
+ *
+ * Example:
+ *   auto p = tiered::plan(data.begin(), data.end());
+ *   if (p.cost > budget) pool.submit(...); else tiered::execute(p, data.begin(), data.end());
+ */
+template<typename RandomIt>
+sort_plan plan(RandomIt first, RandomIt last, sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    sort_plan p;
+    p.n = std::distance(first, last);
+    p.element_bytes = sizeof(T);
+    p.order = order;
+    if (p.n > 1) {
+        detail::plan_tiers(&(*first), p.n, p);
+    }
+    return p;
+}
+
+/**
+ * Sort a range with a plan from tiered::plan(), starting at the planned
+ * tier. The range should be the one that was planned; if its data changed
+ * since, every tier still verifies its input and the result is sorted all
+ * the same (a plan for a different size or element type is ignored).
+ *
+ * @param p Plan returned by tiered::plan() for this range
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ */
+template<typename RandomIt>
+void execute(const sort_plan& p, RandomIt first, RandomIt last) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+    if (p.n != n || p.element_bytes != sizeof(T)) {
+        tiered::sort(first, last, p.order);
+        return;
+    }
+
+    T* arr = &(*first);
+    detail::key_range range{p.min_key, p.max_key};
+    if (p.order == sort_order::descending) {
+        detail::tieredsort_planned_impl<T, true>(arr, n, p.chosen, range);
+    } else {
+        detail::tieredsort_planned_impl<T, false>(arr, n, p.chosen, range);
+    }
+}
+
+// =============================================================================
+// FIXED-WIDTH BYTE KEYS (UUIDs, hashes, composite keys)
+// =============================================================================
+
+namespace detail {
+
+template<typename K>
+struct byte_array_traits : std::false_type {};
+
+template<size_t N>
+struct byte_array_traits<std::array<uint8_t, N>> : std::true_type {
+    static constexpr size_t size = N;
+};
+
+template<bool Descending, typename RandomIt, typename KeyFunc>
+void sort_by_byte_key_impl(RandomIt first, RandomIt last, KeyFunc key_func) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using KeyType = std::decay_t<std::invoke_result_t<KeyFunc, const T&>>;
+    constexpr size_t key_bytes = byte_array_traits<KeyType>::size;
+
+    size_t n = std::distance(first, last);
+    T* items = &(*first);
+
+    auto key_compare = [&key_func](const T& a, const T& b) {
+        if constexpr (Descending) {
+            return key_func(b) < key_func(a);
+        } else {
+            return key_func(a) < key_func(b);
+        }
+    };
+
+    // Small arrays - std::stable_sort wins
     if (n < 256) {
-        std::sort(arr, arr + n);
+        std::stable_sort(first, last, key_compare);
         return;
     }
 
-    // Tier 2: Pattern detection - use std::sort for O(n) on sorted/reversed
-    if (is_pattern_sorted(arr, n)) {
-        std::sort(arr, arr + n);
-        return;
+    auto digit = [&key_func](const T& item, size_t depth) {
+        uint8_t b = key_func(item)[depth];
+        return Descending ? static_cast<uint8_t>(0xFF - b) : b;
+    };
+
+    // Digits are cached per level: key_func may copy the whole array
+    std::vector<T> temp(n);
+    std::vector<uint8_t> digits(n);
+    msd_radix_sort(items, temp.data(), n, 0, key_bytes, digit, key_compare, digits.data());
+}
+
+} // namespace detail
+
+/**
+ * Sort objects by a fixed-width byte key (std::array<uint8_t, N>), compared
+ * lexicographically like memcmp - e.g. UUIDs, hashes, or big-endian packed
+ * composite keys.
+ *
+ * Uses MSD radix sort with pass skipping: key bytes shared by every element
+ * in a bucket (such as the timestamp prefix of UUIDv7) are skipped without
+ * moving any data. This is a STABLE sort.
+ *
+ * @param first Iterator to beginning
+ * @param last Iterator to end
+ * @param key_func Function returning std::array<uint8_t, N> (by value or reference)
+ * @param order Sort direction (ascending by default)
+ *
+ * Example:
+ *   struct Event { std::array<uint8_t, 16> id; int payload; };
+ *   tiered::sort_by_byte_key(events.begin(), events.end(),
+ *                            [](const Event& e) -> const auto& { return e.id; });
+ */
+template<typename RandomIt, typename KeyFunc>
+void sort_by_byte_key(RandomIt first, RandomIt last, KeyFunc key_func,
+                      sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using KeyType = std::decay_t<std::invoke_result_t<KeyFunc, const T&>>;
+
+    static_assert(detail::byte_array_traits<KeyType>::value,
+                  "Key function must return std::array<uint8_t, N>");
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    if (order == sort_order::descending) {
+        detail::sort_by_byte_key_impl<true>(first, last, key_func);
+    } else {
+        detail::sort_by_byte_key_impl<false>(first, last, key_func);
+    }
+}
+
+// =============================================================================
+// STRING SORTING (MSD radix on cached 8-byte prefixes)
+// =============================================================================
+
+namespace detail {
+
+// Buckets at or below this size go to multikey quicksort
+constexpr size_t STRING_SMALL_BUCKET = 64;
+
+// String position plus its next 8 bytes, packed big-endian so that integer
+// order equals byte order. Sorting these keeps comparisons out of the
+// strings' (cache-missing) heap storage.
+struct string_prefix {
+    uint64_t key;
+    size_t index;
+};
+
+inline uint64_t load_string_prefix(std::string_view s, size_t depth) {
+    uint64_t key = 0;
+    size_t len = s.size() > depth ? std::min<size_t>(8, s.size() - depth) : 0;
+    for (size_t i = 0; i < len; i++) {
+        key |= static_cast<uint64_t>(static_cast<uint8_t>(s[depth + i])) << (56 - 8 * i);
     }
+    return key;
+}
 
-    // Tier 3: Dense range detection - use counting sort
-    T min_val, max_val;
-    if (detect_dense_range(arr, n, min_val, max_val)) {
-        counting_sort(arr, n, min_val, max_val);
-        return;
+// Byte at position d, or -1 past the end (end-of-string sorts first)
+inline int string_char_at(std::string_view s, size_t d) {
+    return d < s.size() ? static_cast<uint8_t>(s[d]) : -1;
+}
+
+// Multikey (3-way radix) quicksort on the bytes from `depth` onwards
+inline void multikey_quicksort(string_prefix* items, size_t n, size_t depth,
+                               const std::string_view* views) {
+    while (n > 1) {
+        if (n <= 12) {
+            insertion_sort(items, n, [depth, views](const string_prefix& a, const string_prefix& b) {
+                return views[a.index].substr(std::min(depth, views[a.index].size())) <
+                       views[b.index].substr(std::min(depth, views[b.index].size()));
+            });
+            return;
+        }
+
+        // Median-of-3 pivot character
+        int c0 = string_char_at(views[items[0].index], depth);
+        int c1 = string_char_at(views[items[n / 2].index], depth);
+        int c2 = string_char_at(views[items[n - 1].index], depth);
+        int pivot = std::max(std::min(c0, c1), std::min(std::max(c0, c1), c2));
+
+        // 3-way partition: [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            int c = string_char_at(views[items[i].index], depth);
+            if (c < pivot) {
+                std::swap(items[lt++], items[i++]);
+            } else if (c > pivot) {
+                std::swap(items[i], items[--gt]);
+            } else {
+                i++;
+            }
+        }
+
+        multikey_quicksort(items, lt, depth, views);
+        multikey_quicksort(items + gt, n - gt, depth, views);
+
+        // Equal part: continue on the next byte unless the strings ended
+        if (pivot < 0) return;
+        items += lt;
+        n = gt - lt;
+        depth++;
     }
+}
 
-    // Tier 4: Radix sort for random data
-    if constexpr (sizeof(T) == 4) {
-        radix_sort_32(arr, n, temp);
-    } else {
-        radix_sort_64(arr, n, temp);
+// Sort items whose strings agree on their first `depth` bytes.
+//
+// Every run of equal prefixes but the largest is sorted by a recursive
+// call; the largest continues in this frame on the next 8 bytes. Each call
+// gets at most half the items, so the stack stays O(log n) deep however
+// long the shared prefixes are.
+inline void string_radix_sort(string_prefix* items, string_prefix* temp, size_t n,
+                              size_t depth, const std::string_view* views) {
+    while (n > STRING_SMALL_BUCKET) {
+        // MSD radix on the cached prefixes; bytes shared by the whole bucket
+        // (common URL/log prefixes) are skipped without moving anything, and
+        // a bucket with one prefix throughout skips the radix pass entirely
+        bool all_equal = true;
+        for (size_t i = 1; i < n && all_equal; i++) {
+            all_equal = items[i].key == items[0].key;
+        }
+        if (!all_equal) {
+            msd_radix_sort(items, temp, n, 0, 8,
+                           [](const string_prefix& item, size_t d) {
+                               return static_cast<uint8_t>(item.key >> (56 - 8 * d));
+                           },
+                           [](const string_prefix& a, const string_prefix& b) { return a.key < b.key; });
+        }
+
+        // Resolve ties: runs with equal prefixes need the next 8 bytes
+        size_t next_depth = depth + 8;
+        string_prefix* largest = nullptr;
+        size_t largest_n = 0;
+        size_t i = 0;
+        while (i < n) {
+            size_t j = i + 1;
+            while (j < n && items[j].key == items[i].key) j++;
+
+            if (j - i > 1) {
+                // Strings that end within this prefix are proper prefixes of the
+                // longer ones (zero padding matched), so they go first, by length
+                string_prefix* run = items + i;
+                string_prefix* mid = std::partition(run, items + j, [next_depth, views](const string_prefix& item) {
+                    return views[item.index].size() <= next_depth;
+                });
+                std::sort(run, mid, [views](const string_prefix& a, const string_prefix& b) {
+                    return views[a.index].size() < views[b.index].size();
+                });
+
+                size_t rest = static_cast<size_t>(items + j - mid);
+                if (rest > 1) {
+                    for (string_prefix* p = mid; p != items + j; ++p) {
+                        p->key = load_string_prefix(views[p->index], next_depth);
+                    }
+                    if (rest > largest_n) {
+                        std::swap(mid, largest);
+                        std::swap(rest, largest_n);
+                    }
+                    if (mid) {
+                        string_radix_sort(mid, temp + (mid - items), rest, next_depth, views);
+                    }
+                }
+            }
+            i = j;
+        }
+
+        if (!largest) return;
+        temp += largest - items;
+        items = largest;
+        n = largest_n;
+        depth = next_depth;
     }
+    multikey_quicksort(items, n, depth, views);
 }
 
-// For floating point types (float, double)
-template<typename T>
-typename std::enable_if_t<std::is_floating_point_v<T>>
-tieredsort_impl(T* arr, size_t n, T* temp) {
-    // Tier 1: Small arrays
+} // namespace detail
+
+/**
+ * Sort a range of strings (std::string, std::string_view, or anything
+ * convertible to std::string_view) in byte-wise lexicographic order, the
+ * same order as std::string's operator<.
+ *
+ * MSD radix sort on cached prefixes: the first 8 bytes of every string are
+ * packed into a uint64_t and radix sorted (skipping bytes shared by all
+ * strings), ties recurse on the next 8 bytes, and small buckets finish
+ * with multikey quicksort. Strings are moved once, at the end.
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ *
+ * Example:
+ *   std::vector<std::string> urls = {...};
+ *   tiered::sort_strings(urls.begin(), urls.end());
+ */
+template<typename RandomIt>
+void sort_strings(RandomIt first, RandomIt last) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(std::is_convertible_v<const T&, std::string_view>,
+                  "sort_strings requires elements convertible to std::string_view");
+
+    size_t n = std::distance(first, last);
+    if (n <= 1) return;
+
+    // Tier 1: Small arrays - comparisons are cheap enough
     if (n < 256) {
-        std::sort(arr, arr + n);
+        std::sort(first, last, [](const T& a, const T& b) {
+            return std::string_view(a) < std::string_view(b);
+        });
         return;
     }
 
-    // Tier 2: Pattern detection
-    if (is_pattern_sorted(arr, n)) {
-        std::sort(arr, arr + n);
-        return;
+    std::vector<std::string_view> views(n);
+    std::vector<detail::string_prefix> items(n);
+    std::vector<detail::string_prefix> temp(n);
+    for (size_t i = 0; i < n; i++) {
+        views[i] = std::string_view(*(first + i));
+        items[i] = {detail::load_string_prefix(views[i], 0), i};
     }
 
-    // Tier 4: Radix sort (skip counting sort for floats)
-    if constexpr (sizeof(T) == 4) {
-        radix_sort_32(arr, n, temp);
-    } else {
-        radix_sort_64(arr, n, temp);
+    detail::string_radix_sort(items.data(), temp.data(), n, 0, views.data());
+
+    // Apply the permutation (views point into the originals, so move last)
+    std::vector<T> sorted;
+    sorted.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        sorted.push_back(std::move(*(first + items[i].index)));
     }
+    std::move(sorted.begin(), sorted.end(), first);
 }
 
 // =============================================================================
-// STABLE TIEREDSORT IMPLEMENTATION
+// SELECTION (radix select: nth_element, partial_sort, top_k)
 // =============================================================================
 
-// Stable version for integral types
-template<typename T>
-typename std::enable_if_t<std::is_integral_v<T>>
-tieredsort_stable_impl(T* arr, size_t n, T* temp) {
-    // Tier 1: Small arrays - use std::stable_sort
-    if (n < 256) {
-        std::stable_sort(arr, arr + n);
-        return;
+namespace detail {
+
+// Ranges at or below this size are finished with std::nth_element
+constexpr size_t RADIX_SELECT_SMALL = 256;
+
+// Radix key with the sort direction folded in (same transform as the radix tiers)
+template<typename T, bool Descending>
+inline auto ordered_key(T v) {
+    using K = decltype(to_unsigned(v));
+    K k = to_unsigned(v);
+    return Descending ? static_cast<K>(~k) : k;
+}
+
+template<typename T, bool Descending>
+inline unsigned key_digit(T v, int shift) {
+    return static_cast<unsigned>((ordered_key<T, Descending>(v) >> shift) & 0xFF);
+}
+
+template<typename T, bool Descending>
+struct ordered_key_less {
+    bool operator()(const T& a, const T& b) const {
+        return ordered_key<T, Descending>(a) < ordered_key<T, Descending>(b);
+    }
+};
+
+// Find the bucket holding rank `k` (0-based) given a 256-entry histogram.
+// Returns the bucket and sets `below` to the number of elements in lower buckets.
+template<typename Count>
+inline unsigned find_rank_bucket(const Count* count, size_t k, size_t& below) {
+    size_t acc = 0;
+    unsigned b = 0;
+    while (acc + count[b] <= k) {
+        acc += count[b];
+        b++;
     }
+    below = acc;
+    return b;
+}
 
-    // Tier 2: Pattern detection - use std::stable_sort for O(n) on sorted/reversed
-    if (is_pattern_sorted(arr, n)) {
-        std::stable_sort(arr, arr + n);
-        return;
+// In-place MSD radix select: afterwards arr[k] holds the element of rank k,
+// everything before it is not greater and everything after is not smaller.
+// Only the bucket containing rank k is descended into, so each level
+// touches a fraction of the previous one.
+template<typename T, bool Descending = false>
+void radix_select(T* arr, size_t n, size_t k) {
+    using K = decltype(to_unsigned(std::declval<T>()));
+
+    size_t lo = 0, hi = n;
+    int shift = static_cast<int>(sizeof(K) * 8) - 8;
+    size_t count[256];
+
+    while (hi - lo > RADIX_SELECT_SMALL && shift >= 0) {
+        std::memset(count, 0, sizeof(count));
+        for (size_t i = lo; i < hi; i++) {
+            count[key_digit<T, Descending>(arr[i], shift)]++;
+        }
+
+        size_t below;
+        unsigned b = find_rank_bucket(count, k - lo, below);
+
+        // Pass skipping: the whole range shares this digit
+        if (count[b] == hi - lo) {
+            shift -= 8;
+            continue;
+        }
+
+        // 3-way partition by digit: [lo, lt) < b, [lt, gt) == b, [gt, hi) > b
+        size_t lt = lo, i = lo, gt = hi;
+        while (i < gt) {
+            unsigned d = key_digit<T, Descending>(arr[i], shift);
+            if (d < b) {
+                std::swap(arr[lt++], arr[i++]);
+            } else if (d > b) {
+                std::swap(arr[i], arr[--gt]);
+            } else {
+                i++;
+            }
+        }
+
+        lo = lt;
+        hi = gt;
+        shift -= 8;
     }
 
-    // Tier 3: Dense range detection - use stable counting sort
-    T min_val, max_val;
-    if (detect_dense_range(arr, n, min_val, max_val)) {
-        counting_sort_stable(arr, n, min_val, max_val, temp);
-        return;
+    // Small remainder (or all keys equal): finish with a comparison select
+    if (hi - lo > 1) {
+        std::nth_element(arr + lo, arr + k, arr + hi, ordered_key_less<T, Descending>());
     }
+}
 
-    // Tier 4: Radix sort (already stable due to backwards iteration)
-    if constexpr (sizeof(T) == 4) {
-        radix_sort_32(arr, n, temp);
-    } else {
-        radix_sort_64(arr, n, temp);
+// Histogram of one key digit over the whole array. Four interleaved
+// histograms keep clustered keys from serializing on one counter.
+template<typename T, bool Descending>
+void histogram_digit(const T* arr, size_t n, int shift, size_t* count) {
+    size_t sub[4][256] = {};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        sub[0][key_digit<T, Descending>(arr[i], shift)]++;
+        sub[1][key_digit<T, Descending>(arr[i + 1], shift)]++;
+        sub[2][key_digit<T, Descending>(arr[i + 2], shift)]++;
+        sub[3][key_digit<T, Descending>(arr[i + 3], shift)]++;
+    }
+    for (; i < n; i++) {
+        sub[0][key_digit<T, Descending>(arr[i], shift)]++;
+    }
+    for (int b = 0; b < 256; b++) {
+        count[b] = sub[0][b] + sub[1][b] + sub[2][b] + sub[3][b];
     }
 }
 
-// Stable version for floating point types
-template<typename T>
-typename std::enable_if_t<std::is_floating_point_v<T>>
-tieredsort_stable_impl(T* arr, size_t n, T* temp) {
-    // Tier 1: Small arrays
-    if (n < 256) {
-        std::stable_sort(arr, arr + n);
-        return;
+// Sample size for the small-k threshold filter in select_k_copy
+constexpr size_t SELECT_SAMPLE_SIZE = 1024;
+
+// Small k fast path: a strided sample predicts a key threshold with about
+// 4k elements at or below it, and one filter pass collects just those.
+// Returns false (output untouched) if the sample misjudged the data.
+template<typename T, bool Descending>
+bool select_k_sampled(const T* arr, size_t n, size_t k, T* out) {
+    using K = decltype(to_unsigned(std::declval<T>()));
+
+    size_t stride = n / SELECT_SAMPLE_SIZE;
+    std::array<K, SELECT_SAMPLE_SIZE> sample;
+    for (size_t i = 0; i < SELECT_SAMPLE_SIZE; i++) {
+        sample[i] = ordered_key<T, Descending>(arr[i * stride]);
     }
+    size_t rank = std::min(SELECT_SAMPLE_SIZE - 1, 4 * k / stride);
+    std::nth_element(sample.begin(), sample.begin() + rank, sample.end());
+    K threshold = sample[rank];
+
+    // Give up once the filter keeps far more than predicted
+    size_t expected = (rank + 1) * stride;
+    size_t limit = std::max(expected * 8, k);
+    std::vector<T> candidates;
+    candidates.reserve(expected * 2);
+    for (size_t i = 0; i < n; i++) {
+        if (ordered_key<T, Descending>(arr[i]) <= threshold) {
+            if (candidates.size() == limit) return false;
+            candidates.push_back(arr[i]);
+        }
+    }
+    if (candidates.size() < k) return false;
 
-    // Tier 2: Pattern detection
-    if (is_pattern_sorted(arr, n)) {
-        std::stable_sort(arr, arr + n);
-        return;
+    radix_select<T, Descending>(candidates.data(), candidates.size(), k - 1);
+    std::copy(candidates.begin(), candidates.begin() + k, out);
+    return true;
+}
+
+// Copy the k elements with the smallest ordered keys into out (unordered),
+// without modifying the input. Histogram passes are read-only and narrow
+// the candidate prefix until the boundary bucket is small; one gather pass
+// then copies the sure winners and the boundary candidates.
+template<typename T, bool Descending>
+void select_k_copy(const T* arr, size_t n, size_t k, T* out) {
+    using K = decltype(to_unsigned(std::declval<T>()));
+
+    // Top 1000 of millions: one filter pass beats the histogram passes
+    if (k <= n / 256 && n >= SELECT_SAMPLE_SIZE * 16) {
+        if (select_k_sampled<T, Descending>(arr, n, k, out)) return;
     }
 
-    // Tier 4: Radix sort (already stable)
-    if constexpr (sizeof(T) == 4) {
-        radix_sort_32(arr, n, temp);
-    } else {
-        radix_sort_64(arr, n, temp);
+    K prefix = 0;
+    K mask = 0;
+    size_t below = 0;
+    size_t boundary = n;
+    int shift = static_cast<int>(sizeof(K) * 8) - 8;
+    size_t count[256];
+
+    // Stop narrowing once the boundary bucket is cheap to copy
+    const size_t candidate_limit = std::max(RADIX_SELECT_SMALL, n / 16);
+
+    for (;;) {
+        std::memset(count, 0, sizeof(count));
+        if (mask == 0) {
+            histogram_digit<T, Descending>(arr, n, shift, count);
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                K key = ordered_key<T, Descending>(arr[i]);
+                if ((key & mask) == prefix) {
+                    count[(key >> shift) & 0xFF]++;
+                }
+            }
+        }
+
+        size_t lower;
+        unsigned b = find_rank_bucket(count, k - below, lower);
+        below += lower;
+        boundary = count[b];
+        prefix |= static_cast<K>(static_cast<K>(b) << shift);
+        mask |= static_cast<K>(static_cast<K>(0xFF) << shift);
+
+        if (boundary <= candidate_limit || shift == 0) break;
+        shift -= 8;
+    }
+
+    // Gather: keys below the prefix are winners, keys on it are candidates
+    size_t need = k - below;
+    bool exact = (shift == 0);  // full key fixed: candidates are identical
+    std::vector<T> candidates;
+    if (!exact) candidates.reserve(boundary);
+
+    T* win = out;
+    T* tie = out + below;
+    for (size_t i = 0; i < n; i++) {
+        K key = ordered_key<T, Descending>(arr[i]) & mask;
+        if (key < prefix) {
+            *win++ = arr[i];
+        } else if (key == prefix) {
+            if (exact) {
+                if (need > 0) {
+                    *tie++ = arr[i];
+                    need--;
+                }
+            } else {
+                candidates.push_back(arr[i]);
+            }
+        }
+    }
+
+    if (!exact && need > 0) {
+        radix_select<T, Descending>(candidates.data(), candidates.size(), need - 1);
+        std::copy(candidates.begin(), candidates.begin() + need, tie);
     }
 }
 
 } // namespace detail
 
-// =============================================================================
-// PUBLIC API
-// =============================================================================
-
 /**
- * Sort a range of elements using tieredsort.
+ * Partially sort so that *nth is the element that would be there in a full
+ * sort; no element before nth is greater, none after it is smaller.
  *
- * Supported types: int32_t, uint32_t, int64_t, uint64_t, float, double
+ * MSD radix select: histogram the most significant byte, keep only the
+ * bucket containing nth (3-way partition in place), repeat on the next
+ * byte, and finish the small remainder with std::nth_element. O(n) with no
+ * temp buffer.
  *
  * @param first Iterator to the beginning of the range
+ * @param nth Iterator to the element to place
  * @param last Iterator to the end of the range
+ * @param order Sort direction (ascending by default)
  */
 template<typename RandomIt>
-void sort(RandomIt first, RandomIt last) {
+void nth_element(RandomIt first, RandomIt nth, RandomIt last,
+                 sort_order order = sort_order::ascending) {
     using T = typename std::iterator_traits<RandomIt>::value_type;
     static_assert(
-        std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
-        std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> ||
-        std::is_same_v<T, float> || std::is_same_v<T, double>,
-        "tieredsort only supports int32_t, uint32_t, int64_t, uint64_t, float, double"
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
     );
 
     size_t n = std::distance(first, last);
-    if (n <= 1) return;
+    if (n <= 1 || nth == last) return;
 
     T* arr = &(*first);
+    size_t k = std::distance(first, nth);
+    if (order == sort_order::descending) {
+        detail::radix_select<T, true>(arr, n, k);
+    } else {
+        detail::radix_select<T, false>(arr, n, k);
+    }
+}
 
-    // Tier 1: Small arrays - no allocation needed
-    if (n < 256) {
-        std::sort(arr, arr + n);
-        return;
+/**
+ * Sort the smallest (middle - first) elements into [first, middle); the
+ * order of the remaining elements is unspecified.
+ *
+ * Radix select isolates the first (middle - first) elements in O(n), then
+ * only those are sorted with tieredsort.
+ *
+ * @param first Iterator to the beginning of the range
+ * @param middle End of the range to be sorted
+ * @param last Iterator to the end of the range
+ * @param order Sort direction (ascending by default; descending puts the
+ *              largest elements first)
+ */
+template<typename RandomIt>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last,
+                  sort_order order = sort_order::ascending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    size_t m = std::distance(first, middle);
+    if (m == 0) return;
+
+    if (m < n) {
+        tiered::nth_element(first, middle, last, order);
     }
+    tiered::sort(first, middle, order);
+}
 
-    // Tier 2: Pattern detection - no allocation needed
-    if (detail::is_pattern_sorted(arr, n)) {
-        std::sort(arr, arr + n);
+/**
+ * Copy the k largest elements (or k smallest with sort_order::ascending)
+ * into d_first, sorted in that order. The input is not modified.
+ *
+ * Read-only histogram passes narrow down the key prefix of the k-th
+ * element; one gather pass then copies the sure winners plus the small
+ * boundary bucket, which is resolved with radix select. Memory use is
+ * k + a fraction of n, never a copy of the whole input.
+ *
+ * @param first Iterator to the beginning of the range
+ * @param last Iterator to the end of the range
+ * @param k Number of elements to return (clamped to the range size)
+ * @param d_first Output, contiguous storage for at least k elements
+ * @param order descending (default) for the largest k, ascending for the smallest k
+ * @return Iterator past the last element written
+ *
+ * Example:
+ *   std::vector<float> best(1000);
+ *   tiered::top_k(scores.begin(), scores.end(), 1000, best.begin());
+ */
+template<typename RandomIt, typename OutIt>
+OutIt top_k(RandomIt first, RandomIt last, size_t k, OutIt d_first,
+            sort_order order = sort_order::descending) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    k = std::min(k, n);
+    if (k == 0) return d_first;
+
+    const T* arr = &(*first);
+    T* out = &(*d_first);
+
+    if (k == n) {
+        std::copy(arr, arr + n, out);
+    } else if (order == sort_order::descending) {
+        detail::select_k_copy<T, true>(arr, n, k, out);
+    } else {
+        detail::select_k_copy<T, false>(arr, n, k, out);
+    }
+
+    tiered::sort(out, out + k, order);
+    return d_first + k;
+}
+
+// =============================================================================
+// QUANTILES (shared radix descent, input not modified)
+// =============================================================================
+
+namespace detail {
+
+// Buckets at or below this size are copied out and finished with
+// std::nth_element instead of being refined further
+constexpr size_t QUANTILE_GATHER_LIMIT = 4096;
+
+// Find the elements of several ranks without sorting or copying the input.
+// All ranks share each read-only histogram pass; a pass only refines the
+// buckets that still contain a requested rank, and a bucket small enough
+// to copy is finished directly. Extra memory: one 256-entry histogram or
+// one small buffer per distinct bucket, never O(n).
+template<typename T>
+void select_ranks(const T* arr, size_t n, const size_t* ranks, size_t m, T* out) {
+    using K = decltype(to_unsigned(std::declval<T>()));
+
+    // A bucket that still contains requested ranks
+    struct group {
+        K prefix;
+        size_t below;                 // elements with a smaller prefix
+        size_t count;                 // elements with this prefix
+        std::vector<size_t> targets;  // indices into ranks/out
+        std::vector<T> items;         // copied elements (small buckets)
+    };
+
+    // Split one histogram into groups, one per bucket holding a rank
+    auto split = [&](const size_t* count, K prefix, size_t below, int shift,
+                     const std::vector<size_t>& targets, std::vector<group>& next) {
+        for (size_t t : targets) {
+            size_t lower;
+            unsigned b = find_rank_bucket(count, ranks[t] - below, lower);
+            K p = static_cast<K>(prefix | static_cast<K>(static_cast<K>(b) << shift));
+            if (next.empty() || next.back().prefix != p) {
+                next.push_back(group{p, below + lower, count[b], {}, {}});
+            }
+            next.back().targets.push_back(t);
+        }
+    };
+
+    // Targets ordered by rank so groups come out sorted by prefix
+    std::vector<size_t> order(m);
+    for (size_t i = 0; i < m; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [ranks](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+
+    int shift = static_cast<int>(sizeof(K) * 8) - 8;
+    size_t count[256];
+    histogram_digit<T, false>(arr, n, shift, count);
+
+    std::vector<group> groups;
+    split(count, K(0), 0, shift, order, groups);
+    K mask = static_cast<K>(static_cast<K>(0xFF) << shift);
+
+    std::vector<K> prefixes;
+    std::vector<unsigned char> gather;
+    std::vector<size_t> hist;
+    while (!groups.empty()) {
+        // Fully determined keys need no more passes: every element in the
+        // bucket is equal, so the value follows from the prefix
+        if (shift == 0) {
+            for (const group& g : groups) {
+                for (size_t t : g.targets) out[t] = from_unsigned_key<T>(g.prefix);
+            }
+            return;
+        }
+        shift -= 8;
+
+        // Slot G collects elements outside every active bucket, so the
+        // lookup below needs no branch for the common no-match case
+        const size_t G = groups.size();
+        prefixes.resize(G);
+        gather.assign(G + 1, 0);
+        hist.assign((G + 1) * 256, 0);
+        for (size_t j = 0; j < G; j++) {
+            prefixes[j] = groups[j].prefix;
+            if (groups[j].count <= QUANTILE_GATHER_LIMIT) {
+                gather[j] = 1;
+                groups[j].items.reserve(groups[j].count);
+            }
+        }
+
+        // One read-only pass serves every active bucket
+        for (size_t i = 0; i < n; i++) {
+            K key = to_unsigned(arr[i]);
+            K high = static_cast<K>(key & mask);
+            size_t gi = G;
+            if (G <= 8) {
+                for (size_t j = 0; j < G; j++) gi = (prefixes[j] == high) ? j : gi;
+            } else {
+                auto it = std::lower_bound(prefixes.begin(), prefixes.end(), high);
+                if (it != prefixes.end() && *it == high) gi = static_cast<size_t>(it - prefixes.begin());
+            }
+            if (gather[gi]) {
+                groups[gi].items.push_back(arr[i]);
+            } else {
+                hist[gi * 256 + ((key >> shift) & 0xFF)]++;
+            }
+        }
+
+        std::vector<group> next;
+        for (size_t j = 0; j < G; j++) {
+            group& g = groups[j];
+            if (gather[j]) {
+                // Small bucket: finish each rank with a comparison select
+                for (size_t t : g.targets) {
+                    auto nth = g.items.begin() + static_cast<std::ptrdiff_t>(ranks[t] - g.below);
+                    std::nth_element(g.items.begin(), nth, g.items.end(), ordered_key_less<T, false>());
+                    out[t] = *nth;
+                }
+            } else {
+                split(&hist[j * 256], g.prefix, g.below, shift, g.targets, next);
+            }
+        }
+        groups = std::move(next);
+        mask = static_cast<K>(mask | static_cast<K>(static_cast<K>(0xFF) << shift));
+    }
+}
+
+} // namespace detail
+
+/**
+ * Compute several quantiles of a range in one shared radix descent, without
+ * modifying the input or allocating O(n) memory.
+ *
+ * Quantile q selects the element of rank round(q * (n - 1)) in ascending
+ * order (no interpolation: the result is always an input value), with q
+ * clamped to [0, 1]. Floats are ordered like tiered::sort orders them.
+ *
+ * All requested ranks share one top-digit histogram pass; later passes only
+ * refine the buckets that contain a requested rank, and small buckets are
+ * finished directly. For typical inputs that is 2-3 read-only passes, for
+ * any number of quantiles.
+ *
+ * @param first Iterator to the beginning of the range (must be non-empty)
+ * @param last Iterator to the end of the range
+ * @param qs Range of quantiles in [0, 1] (e.g. std::vector<double>{0.5, 0.99})
+ * @param out Output receiving one value per quantile, in the order of qs
+ * @return Iterator past the last value written (out unchanged if the range is empty)
+ *
+ * Example:
+ *   std::array<double, 4> qs = {0.5, 0.9, 0.99, 0.999};
+ *   std::array<float, 4> p;
+ *   tiered::quantiles(latencies.begin(), latencies.end(), qs, p.begin());
+ */
+template<typename RandomIt, typename QuantileRange, typename OutIt>
+OutIt quantiles(RandomIt first, RandomIt last, const QuantileRange& qs, OutIt out) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    size_t n = std::distance(first, last);
+    if (n == 0) return out;
+
+    std::vector<size_t> ranks;
+    for (double q : qs) {
+        if (!(q > 0.0)) q = 0.0;
+        if (q > 1.0) q = 1.0;
+        ranks.push_back(static_cast<size_t>(q * static_cast<double>(n - 1) + 0.5));
+    }
+
+    std::vector<T> values(ranks.size());
+    detail::select_ranks(&(*first), n, ranks.data(), ranks.size(), values.data());
+    return std::copy(values.begin(), values.end(), out);
+}
+
+// =============================================================================
+// SORT UNIQUE / SORT COUNT (distinct values straight from the tiers)
+// =============================================================================
+
+namespace detail {
+
+// Emit (value, multiplicity) for each run of equal keys in a sorted array.
+// Values compare by bit pattern, matching the radix and counting tiers.
+template<typename T, typename Emit>
+void emit_value_runs(const T* arr, size_t n, Emit& emit) {
+    size_t i = 0;
+    while (i < n) {
+        T v = arr[i];
+        auto k = to_unsigned(v);
+        size_t j = i + 1;
+        while (j < n && to_unsigned(arr[j]) == k) j++;
+        emit(v, j - i);
+        i = j;
+    }
+}
+
+// Same for sorted radix keys (direction folded in by `flip`)
+template<typename T, bool Descending, typename K, typename Emit>
+void emit_key_runs(const K* keys, size_t n, Emit& emit) {
+    constexpr K flip = Descending ? static_cast<K>(~K(0)) : K(0);
+    K prev = keys[0];
+    size_t start = 0;
+    for (size_t i = 1; i < n; i++) {
+        K k = keys[i];
+        if (k != prev) {
+            emit(from_unsigned_key<T>(static_cast<K>(prev ^ flip)), i - start);
+            prev = k;
+            start = i;
+        }
+    }
+    emit(from_unsigned_key<T>(static_cast<K>(prev ^ flip)), n - start);
+}
+
+// Emit the nonzero entries of a histogram whose bucket i holds value base + i
+template<typename T, bool Descending, typename Count, typename ToValue, typename Emit>
+void emit_histogram(const Count* count, size_t buckets, ToValue to_value, Emit& emit) {
+    if constexpr (Descending) {
+        for (size_t i = buckets; i-- > 0;) {
+            if (count[i] != 0) emit(to_value(i), static_cast<size_t>(count[i]));
+        }
+    } else {
+        for (size_t i = 0; i < buckets; i++) {
+            if (count[i] != 0) emit(to_value(i), static_cast<size_t>(count[i]));
+        }
+    }
+}
+
+// Walk the sort tiers, but emit each distinct value once with its count
+// instead of writing every element back. `arr` is used as scratch; emitted
+// values may be written to arr[0..distinct) because emission never runs
+// ahead of the elements still to be read.
+template<typename T, bool Descending, typename Emit>
+void sorted_runs_impl(T* arr, size_t n, Emit& emit) {
+    // Tier 1 and 2: comparison sort (floats by bit pattern, so equal
+    // patterns are contiguous), then collapse runs
+    if (n < 256 || is_pattern_sorted(arr, n)) {
+        std::sort(arr, arr + n, order_compare<T, Descending>());
+        emit_value_runs(arr, n, emit);
         return;
     }
 
-    // Tier 3: Dense range (integers only) - no allocation needed
-    if constexpr (std::is_integral_v<T>) {
-        T min_val, max_val;
-        if (detail::detect_dense_range(arr, n, min_val, max_val)) {
-            detail::counting_sort(arr, n, min_val, max_val);
+    // 8/16-bit types: the histogram over all bit patterns is the answer
+    if constexpr (is_direct_countable_v<T>) {
+        if (use_direct_counting<T>(n)) {
+            auto to_value = [](size_t i) { return from_unsigned_small<T>(static_cast<small_key_t<T>>(i)); };
+            with_direct_counts(arr, n, nullptr, [&emit, &to_value](const auto* count, size_t buckets) {
+                emit_histogram<T, Descending>(count, buckets, to_value, emit);
+            });
             return;
         }
     }
 
-    // Tier 4: Radix sort - only NOW allocate
-    std::vector<T> temp(n);
-    if constexpr (sizeof(T) == 4) {
-        detail::radix_sort_32(arr, n, temp.data());
+    // Tier 3: the counting histogram already holds every multiplicity
+    if constexpr (has_dense_tier_v<T>) {
+        auto emit_counts = [&emit](auto& hist) {
+            auto to_value = [&hist](size_t i) { return hist.value(hist.lo + i); };
+            emit_histogram<T, Descending>(hist.count + hist.lo, hist.hi - hist.lo + 1, to_value, emit);
+        };
+        if (with_dense_histogram(arr, n, emit_counts)) {
+            return;
+        }
+    }
+
+    // Tier 3b: the distinct-value table holds every multiplicity
+    {
+        using K = decltype(to_unsigned(std::declval<T>()));
+        distinct_table<K> table;
+        if (count_few_distinct(arr, n, table)) {
+            std::pair<K, size_t> entries[FEW_DISTINCT_MAX];
+            size_t m = table.sorted(entries);
+            if constexpr (Descending) {
+                std::reverse(entries, entries + m);
+            }
+            for (size_t i = 0; i < m; i++) {
+                emit(from_unsigned_key<T>(entries[i].first), entries[i].second);
+            }
+            return;
+        }
+    }
+
+    // Tier 4: sort the keys and collapse runs while converting them back,
+    // which replaces the radix sort's own convert-back pass
+    if constexpr (sizeof(T) == 16) {
+        std::vector<T> temp(n);
+        radix_sort<T, Descending>(arr, n, temp.data());
+        emit_value_runs(arr, n, emit);
     } else {
-        detail::radix_sort_64(arr, n, temp.data());
+        using K = decltype(to_unsigned(std::declval<T>()));
+        constexpr K flip = Descending ? static_cast<K>(~K(0)) : K(0);
+        K* keys = reinterpret_cast<K*>(arr);
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = static_cast<K>(to_unsigned(arr[i]) ^ flip);
+        }
+        std::vector<K> temp(n);
+        const K* sorted = radix_passes(keys, temp.data(), n);
+        emit_key_runs<T, Descending>(sorted, n, emit);
     }
 }
 
-/**
- * Sort a range using a provided buffer (avoids allocation).
- *
- * @param first Iterator to the beginning of the range
- * @param last Iterator to the end of the range
- * @param buffer Temporary buffer of at least (last - first) elements
- */
-template<typename RandomIt>
-void sort(RandomIt first, RandomIt last, typename std::iterator_traits<RandomIt>::value_type* buffer) {
-    using T = typename std::iterator_traits<RandomIt>::value_type;
-    static_assert(
-        std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
-        std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> ||
-        std::is_same_v<T, float> || std::is_same_v<T, double>,
-        "tieredsort only supports int32_t, uint32_t, int64_t, uint64_t, float, double"
-    );
-
-    size_t n = std::distance(first, last);
-    if (n <= 1) return;
-
-    T* arr = &(*first);
-    detail::tieredsort_impl(arr, n, buffer);
+template<bool Descending, typename T>
+size_t sort_unique_impl(T* arr, size_t n) {
+    size_t out = 0;
+    auto emit = [arr, &out](T v, size_t) { arr[out++] = v; };
+    sorted_runs_impl<T, Descending>(arr, n, emit);
+    return out;
 }
 
+} // namespace detail
+
 /**
- * Stable sort a range of primitive elements using tieredsort.
- *
- * NOTE: For primitive types (integers, floats), stability is technically
- * maintained but is NOT OBSERVABLE - equal values are indistinguishable,
- * so the stable/unstable versions produce identical output.
- *
- * For sorting objects/structs by a key with observable stability,
- * use tiered::sort_by_key() instead.
+ * Sort a range and remove duplicates in one go (sort + std::unique, fused).
  *
- * Supported types: int32_t, uint32_t, int64_t, uint64_t, float, double
+ * Dense and 8/16-bit inputs emit the distinct values straight from the
+ * counting histogram; sparse inputs collapse duplicates while the radix
+ * keys are converted back, so no separate unique pass is made.
+ * Floats are compared by bit pattern: -0.0 and 0.0 stay distinct.
  *
  * @param first Iterator to the beginning of the range
  * @param last Iterator to the end of the range
+ * @param order Sort direction (ascending by default)
+ * @return New end of the range; [new_last, last) is left unspecified
+ *
+ * Example:
+ *   std::vector<int> ids = {5, 3, 5, 1, 3};
+ *   ids.erase(tiered::sort_unique(ids.begin(), ids.end()), ids.end());  // {1, 3, 5}
  */
 template<typename RandomIt>
-void stable_sort(RandomIt first, RandomIt last) {
+RandomIt sort_unique(RandomIt first, RandomIt last, sort_order order = sort_order::ascending) {
     using T = typename std::iterator_traits<RandomIt>::value_type;
     static_assert(
-        std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
-        std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> ||
-        std::is_same_v<T, float> || std::is_same_v<T, double>,
-        "tieredsort only supports int32_t, uint32_t, int64_t, uint64_t, float, double"
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
     );
 
     size_t n = std::distance(first, last);
-    if (n <= 1) return;
+    if (n <= 1) return last;
 
     T* arr = &(*first);
-
-    // Tier 1: Small arrays - no allocation needed
-    if (n < 256) {
-        std::stable_sort(arr, arr + n);
-        return;
-    }
-
-    // Tier 2: Pattern detection - no allocation needed
-    if (detail::is_pattern_sorted(arr, n)) {
-        std::stable_sort(arr, arr + n);
-        return;
-    }
-
-    // Tiers 3 & 4 need temp buffer
-    std::vector<T> temp(n);
-
-    // Tier 3: Dense range (integers only)
-    if constexpr (std::is_integral_v<T>) {
-        T min_val, max_val;
-        if (detail::detect_dense_range(arr, n, min_val, max_val)) {
-            detail::counting_sort_stable(arr, n, min_val, max_val, temp.data());
-            return;
-        }
-    }
-
-    // Tier 4: Radix sort
-    if constexpr (sizeof(T) == 4) {
-        detail::radix_sort_32(arr, n, temp.data());
-    } else {
-        detail::radix_sort_64(arr, n, temp.data());
-    }
+    size_t distinct = (order == sort_order::descending)
+        ? detail::sort_unique_impl<true>(arr, n)
+        : detail::sort_unique_impl<false>(arr, n);
+    return first + static_cast<std::ptrdiff_t>(distinct);
 }
 
 /**
- * Stable sort a range using a provided buffer (avoids allocation).
+ * Write each distinct value of a range, in sorted order, with its count.
  *
- * See stable_sort() note: for primitives, stability is not observable.
- * Use tiered::sort_by_key() for objects with meaningful stability.
+ * Same tiers as sort_unique(); the counting tier emits its histogram
+ * directly. The input range is used as scratch and left unspecified.
  *
  * @param first Iterator to the beginning of the range
  * @param last Iterator to the end of the range
- * @param buffer Temporary buffer of at least (last - first) elements
+ * @param out_values Output for the distinct values
+ * @param out_counts Output for their multiplicities (size_t)
+ * @param order Sort direction (ascending by default)
+ * @return Pair of iterators past the last value and count written
+ *
+ * Example:
+ *   std::vector<int32_t> values;
+ *   std::vector<size_t> counts;
+ *   tiered::sort_count(v.begin(), v.end(), std::back_inserter(values), std::back_inserter(counts));
  */
-template<typename RandomIt>
-void stable_sort(RandomIt first, RandomIt last, typename std::iterator_traits<RandomIt>::value_type* buffer) {
+template<typename RandomIt, typename ValueOut, typename CountOut>
+std::pair<ValueOut, CountOut> sort_count(RandomIt first, RandomIt last, ValueOut out_values,
+                                         CountOut out_counts,
+                                         sort_order order = sort_order::ascending) {
     using T = typename std::iterator_traits<RandomIt>::value_type;
     static_assert(
-        std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
-        std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> ||
-        std::is_same_v<T, float> || std::is_same_v<T, double>,
-        "tieredsort only supports int32_t, uint32_t, int64_t, uint64_t, float, double"
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
     );
 
     size_t n = std::distance(first, last);
-    if (n <= 1) return;
+    if (n == 0) return {out_values, out_counts};
 
+    auto emit = [&out_values, &out_counts](T v, size_t c) {
+        *out_values++ = v;
+        *out_counts++ = c;
+    };
     T* arr = &(*first);
-    detail::tieredsort_stable_impl(arr, n, buffer);
+    if (order == sort_order::descending) {
+        detail::sorted_runs_impl<T, true>(arr, n, emit);
+    } else {
+        detail::sorted_runs_impl<T, false>(arr, n, emit);
+    }
+    return {out_values, out_counts};
 }
 
 // =============================================================================
-// KEY-BASED SORTING (for objects with integer keys)
+// MERGE RUNS (k-way loser tree over sorted runs)
 // =============================================================================
 
 namespace detail {
 
-// Radix sort for 64-bit (key << 32 | index) pairs - stable
-inline void radix_sort_64_stable(uint64_t* arr, size_t n, uint64_t* temp) {
-    uint64_t* src = arr;
-    uint64_t* dst = temp;
-
-    int count[256];
-
-    for (int shift = 0; shift < 64; shift += 8) {
-        std::memset(count, 0, sizeof(count));
-
-        for (size_t i = 0; i < n; i++) {
-            count[(src[i] >> shift) & 0xFF]++;
+// After this many consecutive wins by one run, gallop through it and copy
+// everything up to the runner-up in one block
+constexpr size_t MERGE_GALLOP_STREAK = 8;
+
+// Tournament tree of losers over k sources. keys[i] is the head key of
+// source i and is owned by the caller; after the winner's key changes,
+// replay() restores the tree in log2(k) branch-free steps. Each node keeps
+// a copy of its loser's key so a replay never chases an index.
+template<typename K>
+class loser_tree {
+public:
+    void build(const K* keys, size_t k) {
+        keys_ = keys;
+        k_ = k;
+        loser_.assign(std::max<size_t>(k, 1), 0);
+        loser_key_.assign(std::max<size_t>(k, 1), K());
+        win_.resize(2 * k);
+        for (size_t i = 0; i < k; i++) win_[k + i] = i;
+        for (size_t node = k; node-- > 1;) {
+            size_t a = win_[2 * node];
+            size_t b = win_[2 * node + 1];
+            bool b_wins = keys[b] < keys[a];
+            win_[node] = b_wins ? b : a;
+            loser_[node] = b_wins ? a : b;
+            loser_key_[node] = keys[loser_[node]];
         }
+        loser_[0] = k > 1 ? win_[1] : 0;
+    }
 
-        for (int i = 1; i < 256; i++) {
-            count[i] += count[i - 1];
+    size_t winner() const { return loser_[0]; }
+
+    void replay() {
+        size_t w = loser_[0];
+        K wk = keys_[w];
+        for (size_t node = (w + k_) >> 1; node > 0; node >>= 1) {
+            size_t o = loser_[node];
+            K ok = loser_key_[node];
+            bool o_wins = ok < wk;
+            loser_[node] = o_wins ? w : o;
+            loser_key_[node] = o_wins ? wk : ok;
+            w = o_wins ? o : w;
+            wk = o_wins ? ok : wk;
         }
+        loser_[0] = w;
+    }
 
-        // Backwards iteration for stability
-        for (size_t i = n; i-- > 0;) {
-            dst[--count[(src[i] >> shift) & 0xFF]] = src[i];
+    // Smallest key among the other sources: the second best only ever lost
+    // to the winner, so it sits on the winner's path. Requires k >= 2.
+    K runner_up() const {
+        size_t node = (loser_[0] + k_) >> 1;
+        K best = loser_key_[node];
+        for (node >>= 1; node > 0; node >>= 1) {
+            best = std::min(best, loser_key_[node]);
         }
-
-        std::swap(src, dst);
+        return best;
     }
 
-    // Ensure result is in arr
-    if (src != arr) {
-        std::memcpy(arr, src, n * sizeof(uint64_t));
-    }
-}
+private:
+    const K* keys_ = nullptr;
+    size_t k_ = 0;
+    std::vector<size_t> loser_;   // loser_[0] holds the overall winner
+    std::vector<K> loser_key_;
+    std::vector<size_t> win_;
+};
 
-// Apply permutation - move objects according to sorted indices
 template<typename T>
-void apply_permutation(T* items, const uint32_t* perm, size_t n, T* temp) {
-    for (size_t i = 0; i < n; i++) {
-        temp[i] = std::move(items[perm[i]]);
-    }
-    for (size_t i = 0; i < n; i++) {
-        items[i] = std::move(temp[i]);
+using run_span = std::pair<const T*, const T*>;
+
+// First element of the sorted run [first, last) whose key exceeds `bound`:
+// exponential probe from the front, then binary search
+template<typename T, bool Descending, typename K>
+const T* gallop_past(const T* first, const T* last, K bound) {
+    size_t n = static_cast<size_t>(last - first);
+    size_t lo = 0;
+    size_t step = 1;
+    while (step < n && ordered_key<T, Descending>(first[step]) <= bound) {
+        lo = step;
+        step *= 2;
     }
+    size_t hi = std::min(step, n);
+    return std::upper_bound(first + lo, first + hi, bound,
+        [](K b, const T& v) { return b < ordered_key<T, Descending>(v); });
 }
 
-// Pattern detection for keys
-inline bool is_pattern_sorted_keys(const int32_t* keys, size_t n) {
-    if (n < 8) return true;
-
-    size_t m = n / 2;
-
-    bool head_asc = keys[0] <= keys[1] && keys[1] <= keys[2] && keys[2] <= keys[3];
-    bool head_desc = keys[0] >= keys[1] && keys[1] >= keys[2] && keys[2] >= keys[3];
-    if (!head_asc && !head_desc) return false;
-
-    bool mid_asc = keys[m-1] <= keys[m] && keys[m] <= keys[m+1] && keys[m+1] <= keys[m+2];
-    bool mid_desc = keys[m-1] >= keys[m] && keys[m] >= keys[m+1] && keys[m+1] >= keys[m+2];
-    if (!mid_asc && !mid_desc) return false;
-
-    bool tail_asc = keys[n-4] <= keys[n-3] && keys[n-3] <= keys[n-2] && keys[n-2] <= keys[n-1];
-    bool tail_desc = keys[n-4] >= keys[n-3] && keys[n-3] >= keys[n-2] && keys[n-2] >= keys[n-1];
-    if (!tail_asc && !tail_desc) return false;
-
-    return true;
-}
-
-// Counting sort directly on objects - stable, O(n + range)
-// Much faster than radix sort for dense key ranges
-template<typename T, typename KeyFunc>
-void counting_sort_objects_stable(T* items, size_t n, KeyFunc key_func,
-                                   int32_t min_key, int32_t max_key, T* temp) {
-    size_t range = static_cast<size_t>(max_key - min_key + 1);
-    std::vector<size_t> count(range, 0);
-
-    // Count occurrences
-    for (size_t i = 0; i < n; i++) {
-        int32_t k = key_func(items[i]);
-        count[static_cast<size_t>(k - min_key)]++;
-    }
+template<typename T, bool Descending, typename OutIt>
+OutIt merge_runs_impl(std::vector<run_span<T>> runs, OutIt out) {
+    using K = decltype(ordered_key<T, Descending>(std::declval<T>()));
+
+    runs.erase(std::remove_if(runs.begin(), runs.end(), [](const run_span<T>& r) { return r.first == r.second; }),
+               runs.end());
+
+    std::vector<K> keys;
+    loser_tree<K> tree;
+    auto rebuild = [&] {
+        keys.resize(runs.size());
+        for (size_t i = 0; i < runs.size(); i++) keys[i] = ordered_key<T, Descending>(*runs[i].first);
+        tree.build(keys.data(), runs.size());
+    };
+    rebuild();
+
+    size_t last = runs.size();
+    size_t streak = 0;
+    while (runs.size() > 1) {
+        size_t w = tree.winner();
+        run_span<T>& r = runs[w];
+
+        if (w == last) {
+            streak++;
+        } else {
+            last = w;
+            streak = 0;
+        }
 
-    // Prefix sum
-    for (size_t i = 1; i < range; i++) {
-        count[i] += count[i - 1];
-    }
+        if (streak >= MERGE_GALLOP_STREAK) {
+            const T* stop = gallop_past<T, Descending>(r.first, r.second, tree.runner_up());
+            out = std::copy(r.first, stop, out);
+            r.first = stop;
+            streak = 0;
+        } else {
+            *out = *r.first;
+            ++out;
+            ++r.first;
+        }
 
-    // Place objects in stable order (backwards iteration)
-    for (size_t i = n; i-- > 0;) {
-        int32_t k = key_func(items[i]);
-        size_t idx = static_cast<size_t>(k - min_key);
-        temp[--count[idx]] = std::move(items[i]);
+        if (r.first == r.second) {
+            runs[w] = runs.back();
+            runs.pop_back();
+            rebuild();
+            last = runs.size();
+            continue;
+        }
+        keys[w] = ordered_key<T, Descending>(*r.first);
+        tree.replay();
     }
 
-    // Move back
-    for (size_t i = 0; i < n; i++) {
-        items[i] = std::move(temp[i]);
+    if (!runs.empty()) {
+        out = std::copy(runs[0].first, runs[0].second, out);
     }
+    return out;
 }
 
-// Dense range detection for key-based sorting
-template<typename RandomIt, typename KeyFunc>
-bool detect_dense_range_for_keys(RandomIt first, size_t n, KeyFunc key_func,
-                                  int32_t& out_min, int32_t& out_max) {
-    int32_t min_val = key_func(*first);
-    int32_t max_val = min_val;
+// Element type and spans of a container of contiguous runs
+template<typename RunRange>
+using run_value_t = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(*std::begin(std::declval<const RunRange&>())))>>;
 
-    // Sample 64 values
-    size_t stride = std::max(size_t(1), n / 64);
-    for (size_t i = 0; i < n; i += stride) {
-        int32_t k = key_func(*(first + i));
-        if (k < min_val) min_val = k;
-        if (k > max_val) max_val = k;
+template<typename RunRange>
+std::vector<run_span<run_value_t<RunRange>>> run_spans(const RunRange& runs) {
+    std::vector<run_span<run_value_t<RunRange>>> spans;
+    for (const auto& r : runs) {
+        spans.emplace_back(std::data(r), std::data(r) + std::size(r));
     }
+    return spans;
+}
 
-    int64_t range_est = static_cast<int64_t>(max_val) - static_cast<int64_t>(min_val) + 1;
-    if (range_est > static_cast<int64_t>(n) * 2) {
-        return false;
-    }
+} // namespace detail
 
-    // Full scan for exact bounds
-    for (size_t i = 0; i < n; i++) {
-        int32_t k = key_func(*(first + i));
-        if (k < min_val) min_val = k;
-        if (k > max_val) max_val = k;
-    }
+/**
+ * Merge sorted runs into one sorted sequence.
+ *
+ * k-way tournament (loser) tree with branch-free replays; a run that keeps
+ * winning is galloped and copied in bulk up to the runner-up's key.
+ * Values compare by bit pattern, matching tiered::sort's output order on
+ * every tier (floats: -0.0 before 0.0, NaNs by sign at the ends).
+ *
+ * @param runs Container of sorted runs, each a contiguous range of a
+ *             supported type (std::vector<T>, std::array, spans, ...)
+ * @param out Output iterator receiving every element of every run
+ * @param order Order the runs are sorted in, and of the output
+ * @return Output iterator past the last element written
+ *
+ * Example:
+ *   std::vector<std::vector<uint64_t>> shards = ...;  // each sorted
+ *   std::vector<uint64_t> all;
+ *   tiered::merge_runs(shards, std::back_inserter(all));
+ */
+template<typename RunRange, typename OutIt>
+OutIt merge_runs(const RunRange& runs, OutIt out, sort_order order = sort_order::ascending) {
+    using T = detail::run_value_t<RunRange>;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
 
-    int64_t range = static_cast<int64_t>(max_val) - static_cast<int64_t>(min_val) + 1;
-    if (range <= static_cast<int64_t>(n) * 2) {
-        out_min = min_val;
-        out_max = max_val;
-        return true;
+    if (order == sort_order::descending) {
+        return detail::merge_runs_impl<T, true>(detail::run_spans(runs), out);
     }
-
-    return false;
+    return detail::merge_runs_impl<T, false>(detail::run_spans(runs), out);
 }
 
-// Pattern detection for key-based sorting
-template<typename RandomIt, typename KeyFunc>
-bool is_pattern_sorted_for_keys(RandomIt first, size_t n, KeyFunc key_func) {
-    if (n < 8) return true;
-
-    size_t m = n / 2;
-
-    auto k0 = key_func(*(first));
-    auto k1 = key_func(*(first + 1));
-    auto k2 = key_func(*(first + 2));
-    auto k3 = key_func(*(first + 3));
-
-    bool head_asc = k0 <= k1 && k1 <= k2 && k2 <= k3;
-    bool head_desc = k0 >= k1 && k1 >= k2 && k2 >= k3;
-    if (!head_asc && !head_desc) return false;
-
-    auto km1 = key_func(*(first + m - 1));
-    auto km0 = key_func(*(first + m));
-    auto kmp1 = key_func(*(first + m + 1));
-    auto kmp2 = key_func(*(first + m + 2));
-
-    bool mid_asc = km1 <= km0 && km0 <= kmp1 && kmp1 <= kmp2;
-    bool mid_desc = km1 >= km0 && km0 >= kmp1 && kmp1 >= kmp2;
-    if (!mid_asc && !mid_desc) return false;
+// =============================================================================
+// STREAM SORTER (sort batches as they arrive, merge on finish)
+// =============================================================================
 
-    auto kn4 = key_func(*(first + n - 4));
-    auto kn3 = key_func(*(first + n - 3));
-    auto kn2 = key_func(*(first + n - 2));
-    auto kn1 = key_func(*(first + n - 1));
+namespace detail {
 
-    bool tail_asc = kn4 <= kn3 && kn3 <= kn2 && kn2 <= kn1;
-    bool tail_desc = kn4 >= kn3 && kn3 >= kn2 && kn2 >= kn1;
-    if (!tail_asc && !tail_desc) return false;
+// Merge the adjacent sorted runs [a, b) and [b, c) of arr via scratch
+template<typename T, bool Descending>
+void merge_adjacent(T* arr, size_t a, size_t b, size_t c, std::vector<T>& scratch) {
+    sortable_key_less<T, Descending> less;
+    // Runs already in order (presorted stream): nothing to move
+    if (!less(arr[b], arr[b - 1])) return;
 
-    return true;
+    if (scratch.size() < c - a) scratch.resize(c - a);
+    std::merge(arr + a, arr + b, arr + b, arr + c, scratch.data(), less);
+    std::memcpy(arr + a, scratch.data(), (c - a) * sizeof(T));
 }
 
-} // namespace detail (key-based sorting helpers)
+} // namespace detail
 
 /**
- * Sort objects by a 32-bit integer key using tieredsort's fast algorithms.
- *
- * This is a STABLE sort - objects with equal keys maintain their relative order.
- * Unlike primitive sorting where stability is unobservable, key-based sorting
- * on objects has meaningful, verifiable stability.
- *
- * Performance: 3-5x faster than std::stable_sort for dense key ranges
- * (ages, scores, sensor data). Falls back to std::stable_sort for sparse keys.
+ * Incremental sorter for data that arrives in batches.
  *
- * @param first Iterator to beginning
- * @param last Iterator to end
- * @param key_func Function that extracts int32_t key from object
+ * Each pushed batch is sorted on arrival with the tieredsort tiers and kept
+ * as a run. Runs are merged with a logarithmic policy (every run is more
+ * than twice the size of the next), so at most log2(n) runs are held and
+ * most of the merge work is spread over the pushes. finish()/drain() end
+ * with a single k-way merge_runs() pass over what is left.
  *
  * Example:
- *   struct Person { std::string name; int age; };
- *   std::vector<Person> people = {...};
- *   tiered::sort_by_key(people.begin(), people.end(),
- *                       [](const Person& p) { return p.age; });
+ *   tiered::stream_sorter<uint64_t> s;
+ *   while (auto batch = next_batch()) s.push(batch->begin(), batch->end());
+ *   std::vector<uint64_t> sorted = s.finish();
  */
-template<typename RandomIt, typename KeyFunc>
-void sort_by_key(RandomIt first, RandomIt last, KeyFunc key_func) {
-    using T = typename std::iterator_traits<RandomIt>::value_type;
-    using KeyType = std::invoke_result_t<KeyFunc, const T&>;
+template<typename T>
+class stream_sorter {
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
 
-    static_assert(std::is_same_v<KeyType, int32_t> ||
-                  std::is_same_v<KeyType, uint32_t>,
-                  "Key function must return int32_t or uint32_t");
+public:
+    /**
+     * @param order Sort direction of the final sequence (ascending by default)
+     */
+    explicit stream_sorter(sort_order order = sort_order::ascending) : order_(order) {}
+
+    /**
+     * Sort a batch and add it as a run.
+     *
+     * @param first Iterator to the beginning of the batch
+     * @param last Iterator to the end of the batch
+     */
+    template<typename InputIt>
+    void push(InputIt first, InputIt last) {
+        size_t start = data_.size();
+        data_.insert(data_.end(), first, last);
+        if (data_.size() == start) return;
+
+        if (order_ == sort_order::descending) {
+            add_run<true>(start);
+        } else {
+            add_run<false>(start);
+        }
+    }
 
-    size_t n = std::distance(first, last);
-    if (n <= 1) return;
+    /**
+     * Sort a batch (any container of T) and add it as a run.
+     */
+    template<typename Range>
+    void push(const Range& batch) {
+        push(std::begin(batch), std::end(batch));
+    }
 
-    T* items = &(*first);
+    /** Number of elements pushed since the last finish()/drain(). */
+    size_t size() const { return data_.size(); }
+
+    /** Number of sorted runs currently held (at most log2(size()) + 1). */
+    size_t run_count() const { return starts_.size(); }
+
+    /**
+     * Merge the remaining runs and return the sorted sequence.
+     * The sorter is empty afterwards and can be reused.
+     */
+    std::vector<T> finish() {
+        if (starts_.size() > 1) {
+            scratch_.resize(data_.size());
+            if (order_ == sort_order::descending) {
+                detail::merge_runs_impl<T, true>(runs(), scratch_.data());
+            } else {
+                detail::merge_runs_impl<T, false>(runs(), scratch_.data());
+            }
+            data_.swap(scratch_);
+        }
+        std::vector<T> result;
+        result.swap(data_);
+        starts_.clear();
+        return result;
+    }
 
-    // Tier 1: Small arrays - std::stable_sort wins
-    if (n < 256) {
-        std::stable_sort(first, last, [&key_func](const T& a, const T& b) {
-            return key_func(a) < key_func(b);
-        });
-        return;
+    /**
+     * Write the sorted sequence to `out`; the final k-way merge streams
+     * into it instead of a buffer. The sorter is empty afterwards.
+     *
+     * @return Output iterator past the last element written
+     */
+    template<typename OutIt>
+    OutIt drain(OutIt out) {
+        if (order_ == sort_order::descending) {
+            out = detail::merge_runs_impl<T, true>(runs(), out);
+        } else {
+            out = detail::merge_runs_impl<T, false>(runs(), out);
+        }
+        data_.clear();
+        starts_.clear();
+        return out;
     }
 
-    // Tier 2: Pattern detection - std::stable_sort is O(n) for sorted/reversed
-    if (detail::is_pattern_sorted_for_keys(first, n, key_func)) {
-        std::stable_sort(first, last, [&key_func](const T& a, const T& b) {
-            return key_func(a) < key_func(b);
-        });
-        return;
+private:
+    template<bool Descending>
+    void add_run(size_t start) {
+        size_t n = data_.size() - start;
+        if (scratch_.size() < n) scratch_.resize(n);
+        detail::tieredsort_impl<T, Descending>(data_.data() + start, n, scratch_.data());
+        starts_.push_back(start);
+
+        while (starts_.size() >= 2) {
+            size_t m = starts_.size();
+            if (starts_[m - 1] - starts_[m - 2] > 2 * (data_.size() - starts_[m - 1])) break;
+            merge_last<Descending>();
+        }
     }
 
-    // Tier 3: Dense range - counting sort directly on objects (3-5x faster!)
-    int32_t min_key, max_key;
-    if (detail::detect_dense_range_for_keys(first, n, key_func, min_key, max_key)) {
-        std::vector<T> temp(n);
-        detail::counting_sort_objects_stable(items, n, key_func, min_key, max_key, temp.data());
-        return;
+    template<bool Descending>
+    void merge_last() {
+        size_t m = starts_.size();
+        detail::merge_adjacent<T, Descending>(data_.data(), starts_[m - 2], starts_[m - 1], data_.size(), scratch_);
+        starts_.pop_back();
     }
 
-    // Tier 4: Sparse range - std::stable_sort is highly optimized
-    std::stable_sort(first, last, [&key_func](const T& a, const T& b) {
-        return key_func(a) < key_func(b);
-    });
-}
+    std::vector<detail::run_span<T>> runs() const {
+        std::vector<detail::run_span<T>> spans(starts_.size());
+        for (size_t i = 0; i < starts_.size(); i++) {
+            size_t end = i + 1 < starts_.size() ? starts_[i + 1] : data_.size();
+            spans[i] = {data_.data() + starts_[i], data_.data() + end};
+        }
+        return spans;
+    }
+
+    sort_order order_;
+    std::vector<T> data_;          // all runs, back to back
+    std::vector<size_t> starts_;   // offset of each run in data_
+    std::vector<T> scratch_;       // radix temp buffer and merge target
+};
 
 } // namespace tiered
 
@@ -0,0 +1,850 @@
+/*
+ * tieredsort_external - sort binary files larger than RAM with tieredsort
+ *
+ * Copyright (c) 2025
+ *
+ * MIT License - see tieredsort.hpp for the full text.
+ *
+ * =============================================================================
+ *
+ * Files are flat arrays of fixed-width records (any type tiered::sort
+ * accepts) in native byte order, e.g. the uint64 key dumps of batch jobs.
+ *
+ * How it works:
+ *   Runs:  read a chunk, tiered::sort it (one scratch buffer reused), write
+ *          it to a temp run file. A background I/O thread writes the
+ *          previous run and reads the next chunk while the CPU sorts.
+ *   Merge: k-way loser-tree merge of the runs with large double-buffered reads
+ *          and writes. If the memory budget cannot hold a block per run,
+ *          runs are merged in several passes.
+ *
+ * sort_file() instead sorts a file in place through a memory map, for
+ * files that fit in the address space. merge_runs_parallel() merges
+ * in-memory runs on several threads.
+ *
+ * Usage:
+ *   #include "tieredsort_external.hpp"
+ *
+ *   tiered::external_sort<uint64_t>("keys.bin", "keys.sorted.bin");
+ *   tiered::sort_file<uint64_t>("keys.bin");
+ *
+ * Uses std::thread: link with Threads::Threads (or -pthread).
+ *
+ * =============================================================================
+ */
+
+#ifndef TIEREDSORT_EXTERNAL_HPP
+#define TIEREDSORT_EXTERNAL_HPP
+
+#include "tieredsort.hpp"
+
+#include <condition_variable>
+#include <cerrno>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+// POSIX memory mapping for sort_file(); elsewhere it reads the file into memory
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(TIEREDSORT_HAS_MMAP)
+#define TIEREDSORT_HAS_MMAP 1
+#endif
+
+#ifdef TIEREDSORT_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tiered {
+
+/**
+ * Resource limits for external_sort().
+ */
+struct external_sort_options {
+    size_t memory_bytes = size_t(256) << 20;   // sort buffers and merge blocks
+    size_t io_block_bytes = size_t(8) << 20;   // largest single read or write
+    size_t max_fan_in = 256;                   // run files open at once in a merge pass
+    std::string temp_dir;                      // run files; empty = system temp directory
+};
+
+/**
+ * Resource limits for sort_file().
+ */
+struct file_sort_options {
+    size_t memory_bytes = size_t(1) << 30;     // scratch (radix buffer, counting tables) past this goes to a temp file
+    std::string temp_dir;                      // scratch file; empty = system temp directory
+};
+
+namespace detail {
+
+// Smallest merge block worth a read; below this the merge adds passes
+constexpr size_t EXTERNAL_MIN_BLOCK = size_t(64) << 10;
+
+// Descriptors left to the rest of the process when the fan-in is capped
+// by the open-file limit
+constexpr size_t EXTERNAL_FD_HEADROOM = 64;
+
+// Run files one merge pass may hold open: the requested cap, and under
+// POSIX the soft RLIMIT_NOFILE less headroom. At least 2, so every pass
+// makes progress; more runs take more passes.
+inline size_t open_run_cap(size_t requested) {
+    size_t cap = requested;
+#ifdef TIEREDSORT_HAS_MMAP
+    struct rlimit rl;
+    if (::getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY) {
+        size_t limit = static_cast<size_t>(rl.rlim_cur);
+        cap = std::min(cap, limit > EXTERNAL_FD_HEADROOM ? limit - EXTERNAL_FD_HEADROOM : size_t(2));
+    }
+#endif
+    return std::max<size_t>(cap, 2);
+}
+
+// One background thread running I/O jobs in submission order.
+// The destructor finishes queued jobs, so declare it after the buffers
+// its jobs touch.
+class io_thread {
+public:
+    io_thread() : worker_([this] { run(); }) {}
+
+    ~io_thread() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        worker_.join();
+    }
+
+    io_thread(const io_thread&) = delete;
+    io_thread& operator=(const io_thread&) = delete;
+
+    template<typename F>
+    std::future<void> submit(F&& job) {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::forward<F>(job));
+        std::future<void> done = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.emplace_back([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return done;
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+                if (jobs_.empty()) return;
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+struct file_closer {
+    void operator()(std::FILE* f) const { std::fclose(f); }
+};
+using file_ptr = std::unique_ptr<std::FILE, file_closer>;
+
+// Unbuffered: every transfer is already a large block
+inline file_ptr open_file(const std::string& path, const char* mode) {
+    std::FILE* f = std::fopen(path.c_str(), mode);
+    if (!f) {
+        throw std::system_error(errno, std::generic_category(), "tieredsort: cannot open " + path);
+    }
+    std::setvbuf(f, nullptr, _IONBF, 0);
+    return file_ptr(f);
+}
+
+// Reads up to `count` records; fewer only at end of file
+template<typename T>
+size_t read_records(std::FILE* f, T* out, size_t count) {
+    size_t got = std::fread(out, sizeof(T), count, f);
+    if (got < count && std::ferror(f)) {
+        throw std::system_error(errno, std::generic_category(), "tieredsort: read failed");
+    }
+    return got;
+}
+
+template<typename T>
+void write_records(std::FILE* f, const T* data, size_t count) {
+    if (count == 0) return;
+    if (std::fwrite(data, sizeof(T), count, f) != count) {
+        throw std::system_error(errno, std::generic_category(), "tieredsort: write failed");
+    }
+}
+
+template<typename T>
+void write_file(std::FILE* out, const T* data, size_t count) {
+    write_records(out, data, count);
+    if (std::fflush(out) != 0) {
+        throw std::system_error(errno, std::generic_category(), "tieredsort: write failed");
+    }
+}
+
+template<typename T>
+void write_file(const std::string& path, const T* data, size_t count) {
+    file_ptr out = open_file(path, "wb");
+    write_file(out.get(), data, count);
+}
+
+// A run file just created, open for writing
+struct run_file {
+    std::string path;
+    file_ptr file;
+};
+
+// Temp run files, removed when the set goes out of scope
+class run_files {
+public:
+    explicit run_files(const std::string& dir)
+        : dir_(dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(dir)) {
+#ifndef TIEREDSORT_HAS_MMAP
+        std::random_device rd;
+        tag_ = std::to_string(rd()) + "-" + std::to_string(rd());
+#endif
+    }
+
+    ~run_files() {
+        for (const auto& path : paths_) {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    }
+
+    run_files(const run_files&) = delete;
+    run_files& operator=(const run_files&) = delete;
+
+    // Created exclusively (O_EXCL), so never through a file or symlink
+    // already in the shared temp directory; write through the returned
+    // handle, not by reopening the path
+    run_file create() {
+#ifdef TIEREDSORT_HAS_MMAP
+        std::string name = (dir_ / "tieredsort-run-XXXXXX").string();
+        std::vector<char> buf(name.begin(), name.end());
+        buf.push_back('\0');
+        int fd = ::mkstemp(buf.data());
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "tieredsort: cannot create run file in " + dir_.string());
+        }
+        std::string path(buf.data());
+        paths_.push_back(path);
+        std::FILE* f = ::fdopen(fd, "wb");
+        if (!f) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "tieredsort: cannot open " + path);
+        }
+        std::setvbuf(f, nullptr, _IONBF, 0);
+        return {path, file_ptr(f)};
+#else
+        std::string path = (dir_ / ("tieredsort-" + tag_ + "-" + std::to_string(paths_.size()) + ".run")).string();
+        file_ptr f = open_file(path, "wbx");
+        paths_.push_back(path);
+        return {path, std::move(f)};
+#endif
+    }
+
+    void remove(const std::string& path) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+private:
+    std::filesystem::path dir_;
+#ifndef TIEREDSORT_HAS_MMAP
+    std::string tag_;
+#endif
+    std::vector<std::string> paths_;
+};
+
+// Sequential reader over one run with a block prefetched in the background
+template<typename T>
+struct run_reader {
+    file_ptr file;
+    std::vector<T> blocks[2];
+    size_t cur = 0;
+    size_t pos = 0;
+    size_t len = 0;
+    size_t next_len = 0;
+    std::future<void> pending;
+
+    void prefetch(io_thread& io) {
+        T* dst = blocks[cur ^ 1].data();
+        size_t cap = blocks[cur ^ 1].size();
+        pending = io.submit([this, dst, cap] { next_len = read_records(file.get(), dst, cap); });
+    }
+
+    // Swap in the prefetched block; false once the run is exhausted
+    bool advance_block(io_thread& io) {
+        pending.get();
+        cur ^= 1;
+        len = next_len;
+        pos = 0;
+        if (len == 0) return false;
+        prefetch(io);
+        return true;
+    }
+
+    const T& front() const { return blocks[cur][pos]; }
+};
+
+// k-way merge of sorted run files into `out`, block_elems per buffer
+template<typename T, bool Descending>
+void merge_run_files(const std::vector<std::string>& inputs, std::FILE* out, size_t block_elems) {
+    const size_t k = inputs.size();
+    std::vector<run_reader<T>> readers(k);
+    std::vector<T> out_blocks[2] = {std::vector<T>(block_elems), std::vector<T>(block_elems)};
+    std::future<void> writing;
+    io_thread io;
+
+    // Loser tree over the runs that still have data
+    using K = decltype(ordered_key<T, Descending>(std::declval<T>()));
+    std::vector<size_t> active;
+    active.reserve(k);
+    for (size_t r = 0; r < k; r++) {
+        run_reader<T>& reader = readers[r];
+        reader.file = open_file(inputs[r], "rb");
+        reader.blocks[0].resize(block_elems);
+        reader.blocks[1].resize(block_elems);
+        reader.cur = 1;
+        reader.prefetch(io);
+        if (reader.advance_block(io)) active.push_back(r);
+    }
+
+    std::vector<K> keys;
+    loser_tree<K> tree;
+    auto rebuild = [&] {
+        keys.resize(active.size());
+        for (size_t i = 0; i < active.size(); i++) keys[i] = ordered_key<T, Descending>(readers[active[i]].front());
+        tree.build(keys.data(), active.size());
+    };
+    rebuild();
+
+    size_t o = 0;
+    size_t filled = 0;
+    auto flush = [&] {
+        if (writing.valid()) writing.get();
+        const T* data = out_blocks[o].data();
+        size_t count = filled;
+        writing = io.submit([out, data, count] { write_records(out, data, count); });
+        o ^= 1;
+        filled = 0;
+    };
+
+    while (!active.empty()) {
+        size_t w = tree.winner();
+        run_reader<T>& top = readers[active[w]];
+        out_blocks[o][filled++] = top.front();
+        if (filled == block_elems) flush();
+
+        if (++top.pos == top.len && !top.advance_block(io)) {
+            active[w] = active.back();
+            active.pop_back();
+            rebuild();
+            continue;
+        }
+        keys[w] = ordered_key<T, Descending>(top.front());
+        tree.replay();
+    }
+
+    if (filled > 0) flush();
+    if (writing.valid()) writing.get();
+    if (std::fflush(out) != 0) {
+        throw std::system_error(errno, std::generic_category(), "tieredsort: write failed");
+    }
+}
+
+template<typename T, bool Descending>
+void external_sort_impl(const std::string& input_path, const std::string& output_path,
+                        const external_sort_options& options) {
+    const uintmax_t bytes = std::filesystem::file_size(input_path);
+    if (bytes % sizeof(T) != 0) {
+        throw std::runtime_error("tieredsort: " + input_path + " is not a whole number of records");
+    }
+    const size_t total = static_cast<size_t>(bytes / sizeof(T));
+
+    // Two chunk buffers (one sorting, one in flight) plus the radix scratch
+    const size_t chunk = std::max<size_t>(options.memory_bytes / (3 * sizeof(T)), 256);
+
+    // Fits in one chunk: plain in-memory sort
+    if (total <= chunk) {
+        std::vector<T> data(total);
+        {
+            file_ptr in = open_file(input_path, "rb");
+            if (read_records(in.get(), data.data(), total) != total) {
+                throw std::runtime_error("tieredsort: " + input_path + " changed while reading");
+            }
+        }
+        tieredsort_alloc_impl<T, Descending>(data.data(), total);
+        write_file(output_path, data.data(), total);
+        return;
+    }
+
+    run_files temp(options.temp_dir);
+    std::vector<std::string> runs;
+
+    // Run generation: the I/O thread writes run k-1 and reads chunk k+1
+    // while chunk k is sorted
+    {
+        std::vector<T> bufs[2] = {std::vector<T>(chunk), std::vector<T>(chunk)};
+        std::vector<T> scratch(chunk);
+        file_ptr in = open_file(input_path, "rb");
+        size_t next_len = 0;
+        run_file prev_run;
+        io_thread io;
+
+        size_t cur = 0;
+        size_t cur_len = read_records(in.get(), bufs[0].data(), chunk);
+        size_t prev_len = 0;
+        while (cur_len > 0) {
+            T* other = bufs[cur ^ 1].data();
+            std::FILE* prev_out = nullptr;
+            if (prev_len > 0) {
+                prev_run = temp.create();
+                prev_out = prev_run.file.get();
+            }
+            std::future<void> io_done = io.submit([&in, &next_len, other, prev_out, prev_len, chunk] {
+                if (prev_out) write_file(prev_out, other, prev_len);
+                next_len = read_records(in.get(), other, chunk);
+            });
+            if (prev_out) runs.push_back(prev_run.path);
+
+            tieredsort_impl<T, Descending>(bufs[cur].data(), cur_len, scratch.data());
+            io_done.get();
+
+            prev_len = cur_len;
+            cur_len = next_len;
+            cur ^= 1;
+        }
+        run_file last_run = temp.create();
+        write_file(last_run.file.get(), bufs[cur ^ 1].data(), prev_len);
+        runs.push_back(last_run.path);
+    }
+
+    // Merge: 2 blocks per input run plus 2 output blocks, and no more
+    // open run files than the descriptor limit allows
+    const size_t max_fan_in = std::min(std::max<size_t>(options.memory_bytes / (2 * EXTERNAL_MIN_BLOCK), 3) - 1,
+                                       open_run_cap(options.max_fan_in));
+    auto block_for = [&](size_t fan_in) {
+        size_t block_bytes = std::min(options.io_block_bytes, options.memory_bytes / (2 * (fan_in + 1)));
+        return std::max<size_t>(block_bytes / sizeof(T), 1);
+    };
+
+    size_t next = 0;
+    while (runs.size() - next > max_fan_in) {
+        std::vector<std::string> group(runs.begin() + next, runs.begin() + next + max_fan_in);
+        next += max_fan_in;
+        run_file merged = temp.create();
+        merge_run_files<T, Descending>(group, merged.file.get(), block_for(max_fan_in));
+        runs.push_back(merged.path);
+        for (const auto& path : group) temp.remove(path);
+    }
+
+    std::vector<std::string> last(runs.begin() + next, runs.end());
+    file_ptr out = open_file(output_path, "wb");
+    merge_run_files<T, Descending>(last, out.get(), block_for(last.size()));
+}
+
+#ifdef TIEREDSORT_HAS_MMAP
+
+inline void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), "tieredsort: " + what);
+}
+
+struct fd_handle {
+    int fd;
+    explicit fd_handle(int f) : fd(f) {}
+    ~fd_handle() { if (fd >= 0) ::close(fd); }
+    fd_handle(const fd_handle&) = delete;
+    fd_handle& operator=(const fd_handle&) = delete;
+};
+
+struct mapped_region {
+    void* addr = MAP_FAILED;
+    size_t len = 0;
+
+    mapped_region(int fd, size_t bytes, int flags) : len(bytes) {
+        addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (addr == MAP_FAILED) throw_errno("mmap failed");
+    }
+    ~mapped_region() { if (addr != MAP_FAILED) ::munmap(addr, len); }
+    void advise(int advice) const { ::madvise(addr, len, advice); }  // a hint: failure is harmless
+    mapped_region(const mapped_region&) = delete;
+    mapped_region& operator=(const mapped_region&) = delete;
+};
+
+// Scratch for the radix tier: anonymous memory within the budget, else an
+// unlinked temp file so the kernel can page it out instead of swapping
+inline int scratch_file(const std::string& dir, size_t bytes) {
+    std::filesystem::path base = dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(dir);
+    std::string name = (base / "tieredsort-XXXXXX").string();
+    std::vector<char> buf(name.begin(), name.end());
+    buf.push_back('\0');
+    int fd = ::mkstemp(buf.data());
+    if (fd < 0) throw_errno("cannot create scratch file in " + base.string());
+    ::unlink(buf.data());
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        int err = errno;
+        ::close(fd);
+        errno = err;
+        throw_errno("cannot size scratch file");
+    }
+    return fd;
+}
+
+#ifdef TIEREDSORT_HAS_PMR
+
+// Scratch for sort_file(), mapped only when a tier asks for it: anonymous
+// memory while the live total stays within the budget, beyond that an
+// unlinked temp file. Every table and buffer counts toward the budget,
+// the dense tier's histogram (up to 2n counters) included.
+//
+// The first request also marks the end of the read-only detection passes:
+// `data` goes back to MADV_NORMAL, since a tier may now scatter into it.
+class mapped_scratch_resource : public std::pmr::memory_resource {
+public:
+    mapped_scratch_resource(size_t budget, const std::string& temp_dir, const mapped_region* data = nullptr)
+        : budget_(budget), temp_dir_(temp_dir), data_(data) {}
+
+private:
+    struct mapping {
+        std::unique_ptr<mapped_region> region;
+        bool anonymous;
+    };
+
+    void* do_allocate(size_t bytes, size_t) override {
+        if (data_) {
+            data_->advise(MADV_NORMAL);
+            data_ = nullptr;
+        }
+        bytes = std::max<size_t>(bytes, 1);
+        mapping m;
+        m.anonymous = bytes <= budget_ - std::min(budget_, used_);
+        if (m.anonymous) {
+            m.region = std::make_unique<mapped_region>(-1, bytes, MAP_PRIVATE | MAP_ANONYMOUS);
+            used_ += bytes;
+        } else {
+            fd_handle scratch(scratch_file(temp_dir_, bytes));
+            m.region = std::make_unique<mapped_region>(scratch.fd, bytes, MAP_SHARED);
+        }
+        void* p = m.region->addr;
+        live_.push_back(std::move(m));
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t, size_t) override {
+        for (size_t i = 0; i < live_.size(); i++) {
+            if (live_[i].region->addr != p) continue;
+            if (live_[i].anonymous) used_ -= live_[i].region->len;
+            live_[i] = std::move(live_.back());
+            live_.pop_back();
+            return;
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    size_t budget_;
+    std::string temp_dir_;
+    const mapped_region* data_;
+    size_t used_ = 0;
+    std::vector<mapping> live_;
+};
+
+#endif // TIEREDSORT_HAS_PMR
+
+template<typename T, bool Descending>
+void sort_file_impl(const std::string& path, const file_sort_options& options) {
+    fd_handle file(::open(path.c_str(), O_RDWR));
+    if (file.fd < 0) throw_errno("cannot open " + path);
+
+    struct stat st;
+    if (::fstat(file.fd, &st) != 0) throw_errno("cannot stat " + path);
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    if (bytes % sizeof(T) != 0) {
+        throw std::runtime_error("tieredsort: " + path + " is not a whole number of records");
+    }
+    const size_t n = bytes / sizeof(T);
+    if (n <= 1) return;
+
+    mapped_region data(file.fd, bytes, MAP_SHARED);
+    // Every tier starts with full passes over the file: read it ahead when
+    // it fits the budget (beyond that, readahead would evict itself)
+    if (bytes <= options.memory_bytes) data.advise(MADV_WILLNEED);
+#ifdef TIEREDSORT_HAS_PMR
+    // Detection reads front to back; scratch is mapped lazily, as
+    // tieredsort_alloc_impl allocates it, and the first mapping resets the
+    // advice before any scatter
+    data.advise(MADV_SEQUENTIAL);
+    mapped_scratch_resource scratch(options.memory_bytes, options.temp_dir, &data);
+    workspace ws(&scratch);
+    tieredsort_alloc_impl<T, Descending>(static_cast<T*>(data.addr), n, &ws);
+#else
+    // Without memory resources the radix scratch is mapped up front and
+    // the counting tables come from the heap, outside the budget
+    if (bytes <= options.memory_bytes) {
+        mapped_region temp(-1, bytes, MAP_PRIVATE | MAP_ANONYMOUS);
+        tieredsort_impl<T, Descending>(static_cast<T*>(data.addr), n, static_cast<T*>(temp.addr));
+    } else {
+        fd_handle scratch(scratch_file(options.temp_dir, bytes));
+        mapped_region temp(scratch.fd, bytes, MAP_SHARED);
+        tieredsort_impl<T, Descending>(static_cast<T*>(data.addr), n, static_cast<T*>(temp.addr));
+    }
+#endif
+}
+
+#else
+
+// No mmap: read the whole file, sort, write it back
+template<typename T, bool Descending>
+void sort_file_impl(const std::string& path, const file_sort_options&) {
+    const uintmax_t bytes = std::filesystem::file_size(path);
+    if (bytes % sizeof(T) != 0) {
+        throw std::runtime_error("tieredsort: " + path + " is not a whole number of records");
+    }
+    const size_t n = static_cast<size_t>(bytes / sizeof(T));
+    if (n <= 1) return;
+
+    std::vector<T> data(n);
+    {
+        file_ptr in = open_file(path, "rb");
+        if (read_records(in.get(), data.data(), n) != n) {
+            throw std::runtime_error("tieredsort: " + path + " changed while reading");
+        }
+    }
+    tieredsort_alloc_impl<T, Descending>(data.data(), n);
+    write_file(path, data.data(), n);
+}
+
+#endif
+
+} // namespace detail
+
+/**
+ * Sort a binary file of fixed-width records in place through a memory map.
+ *
+ * The in-memory tiers run directly on the mapping, so the data is never
+ * copied into a heap buffer. Scratch is mapped only when a tier needs it:
+ * anonymous memory while the total (radix buffer, counting histograms)
+ * stays within options.memory_bytes, beyond that a mapped temp file.
+ * Without POSIX mmap the file is read, sorted and written back.
+ *
+ * @tparam T Record type (any type tiered::sort accepts), native byte order
+ * @param path File to sort; its size must be a multiple of sizeof(T)
+ * @param options Scratch memory budget and temp directory
+ * @param order Sort direction (ascending by default)
+ * @throws std::system_error on I/O failure, std::runtime_error on a
+ *         malformed file
+ */
+template<typename T>
+void sort_file(const std::string& path, const file_sort_options& options = {},
+               sort_order order = sort_order::ascending) {
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    if (order == sort_order::descending) {
+        detail::sort_file_impl<T, true>(path, options);
+    } else {
+        detail::sort_file_impl<T, false>(path, options);
+    }
+}
+
+/**
+ * Sort a binary file of fixed-width records that may not fit in memory.
+ *
+ * The input is cut into chunks sorted with tiered::sort, written to temp
+ * run files and k-way merged into the output. Disk I/O overlaps with
+ * sorting and merging through double buffering.
+ *
+ * Input and output may be the same path.
+ *
+ * @tparam T Record type (any type tiered::sort accepts), native byte order
+ * @param input_path File to sort; its size must be a multiple of sizeof(T)
+ * @param output_path File to write the sorted records to (truncated)
+ * @param options Memory budget, I/O block size and temp directory
+ * @param order Sort direction (ascending by default)
+ * @throws std::system_error on I/O failure, std::runtime_error on a
+ *         malformed input file
+ */
+template<typename T>
+void external_sort(const std::string& input_path, const std::string& output_path,
+                   const external_sort_options& options = {}, sort_order order = sort_order::ascending) {
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    if (order == sort_order::descending) {
+        detail::external_sort_impl<T, true>(input_path, output_path, options);
+    } else {
+        detail::external_sort_impl<T, false>(input_path, output_path, options);
+    }
+}
+
+// =============================================================================
+// PARALLEL MERGE (in-memory runs, one thread per output slice)
+// =============================================================================
+
+namespace detail {
+
+// Smallest output share worth a thread in merge_runs_parallel
+constexpr size_t PARALLEL_MERGE_MIN = size_t(1) << 16;
+
+// Co-ranking: cut every run so that exactly `rank` elements lie before the
+// cuts and none of them orders after an element behind a cut. Bisects the
+// key space for the smallest key whose count reaches `rank`, then hands
+// out elements equal to it run by run.
+template<typename T, bool Descending>
+void co_rank(const std::vector<run_span<T>>& runs, size_t rank, std::vector<const T*>& cuts) {
+    using K = decltype(ordered_key<T, Descending>(std::declval<T>()));
+    auto key_before = [](const T& v, K k) { return ordered_key<T, Descending>(v) < k; };
+    auto key_after = [](K k, const T& v) { return k < ordered_key<T, Descending>(v); };
+
+    K lo = 0;
+    K hi = static_cast<K>(~K(0));
+    while (lo < hi) {
+        K mid = static_cast<K>(lo + (hi - lo) / 2);
+        size_t count = 0;
+        for (const auto& r : runs) {
+            count += static_cast<size_t>(std::upper_bound(r.first, r.second, mid, key_after) - r.first);
+        }
+        if (count >= rank) {
+            hi = mid;
+        } else {
+            lo = static_cast<K>(mid + 1);
+        }
+    }
+
+    size_t below = 0;
+    cuts.resize(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+        cuts[i] = std::lower_bound(runs[i].first, runs[i].second, lo, key_before);
+        below += static_cast<size_t>(cuts[i] - runs[i].first);
+    }
+    size_t need = rank - below;
+    for (size_t i = 0; i < runs.size() && need > 0; i++) {
+        const T* eq_end = std::upper_bound(cuts[i], runs[i].second, lo, key_after);
+        size_t take = std::min(need, static_cast<size_t>(eq_end - cuts[i]));
+        cuts[i] += take;
+        need -= take;
+    }
+}
+
+// Joins every started thread on the way out, also when starting another
+// or the caller's own share throws: an unjoined std::thread terminates
+struct thread_joiner {
+    std::vector<std::thread> threads;
+
+    ~thread_joiner() {
+        for (auto& t : threads) t.join();
+    }
+};
+
+template<typename T, bool Descending, typename RandomIt>
+RandomIt merge_runs_parallel_impl(const std::vector<run_span<T>>& runs, RandomIt out, size_t threads) {
+    size_t total = 0;
+    for (const auto& r : runs) total += static_cast<size_t>(r.second - r.first);
+
+    size_t parts = std::min(threads, std::max<size_t>(total / PARALLEL_MERGE_MIN, 1));
+    if (parts <= 1) {
+        return merge_runs_impl<T, Descending>(runs, out);
+    }
+
+    std::vector<std::vector<const T*>> cuts(parts + 1);
+    cuts[0].resize(runs.size());
+    cuts[parts].resize(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+        cuts[0][i] = runs[i].first;
+        cuts[parts][i] = runs[i].second;
+    }
+    for (size_t p = 1; p < parts; p++) {
+        co_rank<T, Descending>(runs, total / parts * p, cuts[p]);
+    }
+
+    auto merge_part = [&](size_t p) {
+        std::vector<run_span<T>> part(runs.size());
+        for (size_t i = 0; i < runs.size(); i++) part[i] = {cuts[p][i], cuts[p + 1][i]};
+        merge_runs_impl<T, Descending>(std::move(part), out + static_cast<std::ptrdiff_t>(total / parts * p));
+    };
+
+    // Worker exceptions (bad_alloc, a throwing output) come back through
+    // the futures and are rethrown here once every worker has finished
+    std::vector<std::future<void>> done;
+    done.reserve(parts - 1);
+    thread_joiner workers;
+    workers.threads.reserve(parts - 1);
+    for (size_t p = 1; p < parts; p++) {
+        std::packaged_task<void()> task([&merge_part, p] { merge_part(p); });
+        done.push_back(task.get_future());
+        workers.threads.emplace_back(std::move(task));
+    }
+    merge_part(0);
+    for (auto& f : done) f.wait();
+    for (auto& f : done) f.get();
+    return out + static_cast<std::ptrdiff_t>(total);
+}
+
+} // namespace detail
+
+/**
+ * Parallel merge_runs(): the output is split into equal slices by
+ * co-ranking (a cut in every run per slice boundary) and each slice is
+ * merged on its own thread.
+ *
+ * @param runs Container of sorted runs, each a contiguous range
+ * @param out Random-access output with room for every element
+ * @param threads Thread count; 0 = std::thread::hardware_concurrency()
+ * @param order Order the runs are sorted in, and of the output
+ * @return Output iterator past the last element written
+ * @throws Whatever the output or an allocation throws on any thread, once
+ *         all threads have stopped; std::system_error if a thread cannot start
+ */
+template<typename RunRange, typename RandomIt>
+RandomIt merge_runs_parallel(const RunRange& runs, RandomIt out, size_t threads = 0,
+                             sort_order order = sort_order::ascending) {
+    using T = detail::run_value_t<RunRange>;
+    static_assert(
+        detail::is_sortable_v<T>,
+        "tieredsort only supports 8/16-bit integers, int32_t, uint32_t, int64_t, uint64_t, "
+        "float, double, 16-bit floats and 128-bit integers"
+    );
+
+    if (threads == 0) {
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    if (order == sort_order::descending) {
+        return detail::merge_runs_parallel_impl<T, true>(detail::run_spans(runs), out, threads);
+    }
+    return detail::merge_runs_parallel_impl<T, false>(detail::run_spans(runs), out, threads);
+}
+
+} // namespace tiered
+
+#endif // TIEREDSORT_EXTERNAL_HPP
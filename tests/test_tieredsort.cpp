@@ -2,10 +2,11 @@
  * tieredsort - Test Suite
  *
  * Comprehensive tests for all supported types and patterns.
- * Run with: g++ -std=c++17 -O3 -o test tests/test_tieredsort.cpp && ./test
+ * Run with: g++ -std=c++17 -O3 -pthread -I include -o test tests/test_tieredsort.cpp && ./test
  */
 
 #include "tieredsort.hpp"
+#include "tieredsort_external.hpp"
 #include <iostream>
 #include <vector>
 #include <random>
@@ -14,6 +15,20 @@
 #include <functional>
 #include <iomanip>
 #include <string>
+#include <string_view>
+#include <array>
+#include <cstring>
+#include <cmath>
+#include <filesystem>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#ifdef _MSC_VER
+#include <malloc.h>
+#define TEST_NOINLINE __declspec(noinline)
+#else
+#define TEST_NOINLINE [[gnu::noinline]]
+#endif
 
 // =============================================================================
 // Test Infrastructure
@@ -22,6 +37,80 @@
 int tests_passed = 0;
 int tests_failed = 0;
 
+// Counts every global operator new, for the zero-allocation tests. Every
+// new/delete form is replaced, so all of them pair malloc with free, or
+// _aligned_malloc with _aligned_free on MSVC (the library's own
+// nothrow/aligned forms would otherwise hand us foreign memory). Atomic: the parallel merge and external-sort tests allocate on
+// worker threads.
+std::atomic<size_t> heap_allocations{0};
+
+namespace {
+
+// align 0: the plain forms; otherwise the std::align_val_t forms
+void* counted_alloc(size_t size, size_t align = 0) {
+    heap_allocations++;
+    if (size == 0) size = 1;
+#ifdef _MSC_VER
+    // No aligned_alloc in MSVC's CRT; _aligned_malloc memory must go back
+    // through _aligned_free (counted_aligned_free)
+    if (align != 0) return _aligned_malloc(size, align);
+#else
+    if (align > alignof(std::max_align_t)) {
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+    }
+#endif
+    return std::malloc(size);
+}
+
+void* counted_alloc_or_throw(size_t size, size_t align = 0) {
+    if (void* p = counted_alloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+
+// Out of line: GCC -O1 otherwise inlines free() into the deletes and then
+// pairs it with the (replaced) operator new as a mismatch
+TEST_NOINLINE void counted_free(void* p) noexcept { std::free(p); }
+
+TEST_NOINLINE void counted_aligned_free(void* p) noexcept {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+void* operator new(size_t size) { return counted_alloc_or_throw(size); }
+void* operator new[](size_t size) { return counted_alloc_or_throw(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new(size_t size, std::align_val_t al) {
+    return counted_alloc_or_throw(size, static_cast<size_t>(al));
+}
+void* operator new[](size_t size, std::align_val_t al) {
+    return counted_alloc_or_throw(size, static_cast<size_t>(al));
+}
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<size_t>(al));
+}
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<size_t>(al));
+}
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, size_t) noexcept { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { counted_aligned_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_aligned_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_aligned_free(p); }
+
 template<typename T>
 bool is_sorted(const std::vector<T>& v) {
     for (size_t i = 1; i < v.size(); i++) {
@@ -55,6 +144,26 @@ void run_test(const std::string& name, std::vector<T> data) {
     }
 }
 
+template<typename T>
+void run_desc_test(const std::string& name, std::vector<T> data, bool stable = false) {
+    auto expected = data;
+    std::sort(expected.begin(), expected.end(), std::greater<T>());
+
+    if (stable) {
+        tiered::stable_sort(data.begin(), data.end(), tiered::sort_order::descending);
+    } else {
+        tiered::sort(data.begin(), data.end(), tiered::sort_order::descending);
+    }
+
+    if (data == expected) {
+        tests_passed++;
+        std::cout << "  [PASS] " << name << "\n";
+    } else {
+        tests_failed++;
+        std::cout << "  [FAIL] " << name << "\n";
+    }
+}
+
 // =============================================================================
 // Data Generators
 // =============================================================================
@@ -240,6 +349,72 @@ void test_double() {
     run_test<double>("large magnitudes", {1e100, -1e100, 1e-100, -1e-100, 0.0});
 }
 
+// =============================================================================
+// 8/16-bit Type Tests (direct counting sort)
+// =============================================================================
+
+// uniform_int_distribution does not accept char types, so draw ints and narrow
+template<typename T>
+std::vector<T> generate_random_small(size_t n, uint32_t seed = 12345) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(std::numeric_limits<T>::min(),
+                                            std::numeric_limits<T>::max());
+    std::vector<T> data(n);
+    for (size_t i = 0; i < n; i++) data[i] = static_cast<T>(dist(rng));
+    return data;
+}
+
+template<typename T>
+void test_small_type(const std::string& type_name) {
+    std::cout << "\n=== Testing " << type_name << " ===\n";
+
+    run_test<T>("empty", {});
+    run_test<T>("three elements", {T(3), T(1), T(2)});
+    run_test<T>("100 random", generate_random_small<T>(100));
+    run_test<T>("1000 random", generate_random_small<T>(1000));
+    run_test<T>("1000 sorted", generate_sorted<T>(1000));
+    run_test<T>("1000 all same", std::vector<T>(1000, T(42)));
+    run_test<T>("10000 few unique", generate_few_unique<T>(10000));
+    run_test<T>("100000 random", generate_random_small<T>(100000));
+
+    run_desc_test<T>("1000 random descending", generate_random_small<T>(1000));
+    run_desc_test<T>("100000 random descending", generate_random_small<T>(100000));
+    run_desc_test<T>("100000 random stable descending", generate_random_small<T>(100000), true);
+
+    // Extremes of the type
+    std::vector<T> extremes(1000);
+    for (size_t i = 0; i < extremes.size(); i++) {
+        extremes[i] = (i % 3 == 0) ? std::numeric_limits<T>::min()
+                    : (i % 3 == 1) ? std::numeric_limits<T>::max() : T(0);
+    }
+    run_test<T>("1000 min/max/zero", extremes);
+
+    // stable_sort shares the same path
+    {
+        auto data = generate_random_small<T>(100000, 4242);
+        auto expected = data;
+        std::sort(expected.begin(), expected.end());
+        tiered::stable_sort(data.begin(), data.end());
+
+        if (data == expected) {
+            tests_passed++;
+            std::cout << "  [PASS] stable_sort 100000 random\n";
+        } else {
+            tests_failed++;
+            std::cout << "  [FAIL] stable_sort 100000 random\n";
+        }
+    }
+}
+
+void test_small_types() {
+    test_small_type<int8_t>("int8_t");
+    test_small_type<uint8_t>("uint8_t");
+    test_small_type<int16_t>("int16_t");
+    test_small_type<uint16_t>("uint16_t");
+    test_small_type<char>("char");
+    test_small_type<char16_t>("char16_t");
+}
+
 // =============================================================================
 // Buffer API Tests
 // =============================================================================
@@ -683,6 +858,2002 @@ void test_sort_by_key() {
     }
 }
 
+// =============================================================================
+// Descending Order Tests
+// =============================================================================
+
+void test_descending() {
+    std::cout << "\n=== Descending Order Tests ===\n";
+
+    run_desc_test<int32_t>("int32 small", generate_random<int32_t>(100));
+    run_desc_test<int32_t>("int32 sorted", generate_sorted<int32_t>(1000));
+    run_desc_test<int32_t>("int32 dense", generate_dense<int32_t>(10000, -50, 50));
+    run_desc_test<int32_t>("int32 random", generate_random<int32_t>(10000));
+    run_desc_test<uint32_t>("uint32 random", generate_random<uint32_t>(10000));
+    run_desc_test<int64_t>("int64 random", generate_random<int64_t>(10000));
+    run_desc_test<uint64_t>("uint64 dense", generate_dense<uint64_t>(10000, 0, 100));
+    run_desc_test<float>("float random", generate_random<float>(10000));
+    run_desc_test<double>("double random", generate_random<double>(10000));
+    run_desc_test<int32_t>("stable int32 dense", generate_dense<int32_t>(10000, 0, 100), true);
+    run_desc_test<int64_t>("stable int64 random", generate_random<int64_t>(10000), true);
+    run_desc_test<double>("stable double random", generate_random<double>(10000), true);
+
+    // Buffer overload
+    {
+        auto data = generate_random<int32_t>(10000, 777);
+        auto expected = data;
+        std::sort(expected.begin(), expected.end(), std::greater<int32_t>());
+
+        std::vector<int32_t> buffer(data.size());
+        tiered::sort(data.begin(), data.end(), buffer.data(), tiered::sort_order::descending);
+
+        if (data == expected) {
+            tests_passed++;
+            std::cout << "  [PASS] descending buffer API\n";
+        } else {
+            tests_failed++;
+            std::cout << "  [FAIL] descending buffer API\n";
+        }
+    }
+
+    // sort_by_key: descending must keep equal keys in original order
+    for (size_t n : {size_t(100), size_t(10000)}) {
+        std::vector<Record> our_records(n);
+        std::mt19937 rng(42);
+        for (size_t i = 0; i < n; i++) {
+            our_records[i] = {static_cast<int32_t>(rng() % 100), static_cast<int32_t>(i)};
+        }
+        auto std_records = our_records;
+
+        tiered::sort_by_key(our_records.begin(), our_records.end(),
+            [](const Record& r) { return r.key; }, tiered::sort_order::descending);
+        std::stable_sort(std_records.begin(), std_records.end(),
+            [](const Record& a, const Record& b) { return a.key > b.key; });
+
+        bool match = true;
+        for (size_t i = 0; i < n; i++) {
+            if (our_records[i].key != std_records[i].key ||
+                our_records[i].original_pos != std_records[i].original_pos) {
+                match = false;
+                break;
+            }
+        }
+
+        if (match) {
+            tests_passed++;
+            std::cout << "  [PASS] sort_by_key descending stable (" << n << " elements)\n";
+        } else {
+            tests_failed++;
+            std::cout << "  [FAIL] sort_by_key descending stable (" << n << " elements)\n";
+        }
+    }
+}
+
+// Test struct with narrow keys
+struct Labeled {
+    uint8_t label;
+    int16_t level;
+    int32_t original_pos;
+};
+
+void test_sort_by_small_key() {
+    std::cout << "\n=== sort_by_key with 8/16-bit keys ===\n";
+
+    const size_t N = 10000;
+    std::vector<Labeled> records(N);
+    std::mt19937 rng(7);
+    for (size_t i = 0; i < N; i++) {
+        records[i] = {static_cast<uint8_t>(rng()), static_cast<int16_t>(rng()),
+                      static_cast<int32_t>(i)};
+    }
+
+    auto check = [&](const std::string& name, auto key_func, tiered::sort_order order) {
+        auto ours = records;
+        auto expected = records;
+        tiered::sort_by_key(ours.begin(), ours.end(), key_func, order);
+        std::stable_sort(expected.begin(), expected.end(),
+            [&](const Labeled& a, const Labeled& b) {
+                return order == tiered::sort_order::descending ? key_func(b) < key_func(a)
+                                                               : key_func(a) < key_func(b);
+            });
+
+        bool match = true;
+        for (size_t i = 0; i < ours.size(); i++) {
+            if (ours[i].original_pos != expected[i].original_pos) {
+                match = false;
+                break;
+            }
+        }
+
+        if (match) {
+            tests_passed++;
+            std::cout << "  [PASS] " << name << "\n";
+        } else {
+            tests_failed++;
+            std::cout << "  [FAIL] " << name << "\n";
+        }
+    };
+
+    auto by_label = [](const Labeled& r) { return r.label; };
+    auto by_level = [](const Labeled& r) { return r.level; };
+    check("uint8_t key", by_label, tiered::sort_order::ascending);
+    check("uint8_t key descending", by_label, tiered::sort_order::descending);
+    check("int16_t key", by_level, tiered::sort_order::ascending);
+    check("int16_t key descending", by_level, tiered::sort_order::descending);
+
+    // Dense 16-bit keys take the counting path; sparse ones (a few hundred
+    // keys over the whole 16-bit range) the stable comparison path
+    for (auto& r : records) r.level = static_cast<int16_t>(static_cast<int>(rng() % 6000) - 3000);
+    check("int16_t dense key", by_level, tiered::sort_order::ascending);
+    records.resize(300);
+    for (auto& r : records) r.level = static_cast<int16_t>(rng());
+    check("int16_t sparse key, 300 records", by_level, tiered::sort_order::descending);
+}
+
+// =============================================================================
+// 128-bit and Byte-Key Tests (MSD radix with pass skipping)
+// =============================================================================
+
+void report(const std::string& name, bool pass) {
+    if (pass) {
+        tests_passed++;
+        std::cout << "  [PASS] " << name << "\n";
+    } else {
+        tests_failed++;
+        std::cout << "  [FAIL] " << name << "\n";
+    }
+}
+
+#ifdef TIEREDSORT_HAS_INT128
+template<typename T>
+void check_wide(const std::string& name, std::vector<T> data,
+                tiered::sort_order order = tiered::sort_order::ascending) {
+    auto expected = data;
+    if (order == tiered::sort_order::descending) {
+        std::sort(expected.begin(), expected.end(), std::greater<T>());
+    } else {
+        std::sort(expected.begin(), expected.end());
+    }
+    tiered::sort(data.begin(), data.end(), order);
+    report(name, data == expected);
+}
+
+void test_int128() {
+    std::cout << "\n=== 128-bit Integer Tests ===\n";
+    using i128 = tiered::detail::int128;
+    using u128 = tiered::detail::uint128;
+
+    std::mt19937_64 rng(128);
+    auto random_u128 = [&]() { return (u128(rng()) << 64) | rng(); };
+
+    std::vector<u128> random(100000);
+    for (auto& x : random) x = random_u128();
+    check_wide<u128>("uint128 100 random", std::vector<u128>(random.begin(), random.begin() + 100));
+    check_wide<u128>("uint128 100000 random", random);
+    check_wide<u128>("uint128 100000 random descending", random, tiered::sort_order::descending);
+
+    // Small values: the top 12 bytes are zero and must be skipped
+    std::vector<u128> small(100000);
+    for (auto& x : small) x = rng() % 1000000;
+    check_wide<u128>("uint128 small values", small);
+
+    // UUIDv7-like: 48-bit timestamp prefix from a narrow window, random tail
+    std::vector<u128> uuid7(100000);
+    for (size_t i = 0; i < uuid7.size(); i++) {
+        u128 ts = 0x018F00000000ull + (rng() % 4096);
+        uuid7[i] = (ts << 80) | (random_u128() & ((u128(1) << 80) - 1));
+    }
+    check_wide<u128>("uint128 UUIDv7 clustered prefix", uuid7);
+
+    std::vector<i128> signed_vals(100000);
+    for (auto& x : signed_vals) x = static_cast<i128>(random_u128());
+    check_wide<i128>("int128 100000 random (mixed signs)", signed_vals);
+    check_wide<i128>("int128 descending", signed_vals, tiered::sort_order::descending);
+
+    std::vector<i128> sorted(1000);
+    for (size_t i = 0; i < sorted.size(); i++) sorted[i] = static_cast<i128>(i) - 500;
+    check_wide<i128>("int128 sorted", sorted);
+
+    // stable_sort and buffer API
+    {
+        auto data = signed_vals;
+        auto expected = data;
+        std::sort(expected.begin(), expected.end());
+        std::vector<i128> buffer(data.size());
+        tiered::stable_sort(data.begin(), data.end(), buffer.data());
+        report("int128 stable_sort buffer API", data == expected);
+    }
+}
+#endif
+
+struct Event {
+    std::array<uint8_t, 16> id;
+    int32_t original_pos;
+};
+
+void test_sort_by_byte_key() {
+    std::cout << "\n=== sort_by_byte_key Tests ===\n";
+
+    std::mt19937 rng(16);
+    const size_t N = 20000;
+
+    auto by_id = [](const Event& e) -> const std::array<uint8_t, 16>& { return e.id; };
+
+    auto check = [&](const std::string& name, std::vector<Event> events, tiered::sort_order order) {
+        auto expected = events;
+        std::stable_sort(expected.begin(), expected.end(), [&](const Event& a, const Event& b) {
+            return order == tiered::sort_order::descending ? b.id < a.id : a.id < b.id;
+        });
+        tiered::sort_by_byte_key(events.begin(), events.end(), by_id, order);
+
+        bool match = true;
+        for (size_t i = 0; i < events.size(); i++) {
+            if (events[i].original_pos != expected[i].original_pos) {
+                match = false;
+                break;
+            }
+        }
+        report(name, match);
+    };
+
+    // Random UUIDs
+    std::vector<Event> random(N);
+    for (size_t i = 0; i < N; i++) {
+        for (auto& b : random[i].id) b = static_cast<uint8_t>(rng());
+        random[i].original_pos = static_cast<int32_t>(i);
+    }
+    check("random 16-byte keys", random, tiered::sort_order::ascending);
+    check("random 16-byte keys descending", random, tiered::sort_order::descending);
+
+    // UUIDv7-like: shared timestamp prefix, many duplicates (stability)
+    std::vector<Event> clustered(N);
+    for (size_t i = 0; i < N; i++) {
+        clustered[i].id = {};
+        clustered[i].id[0] = 0x01;
+        clustered[i].id[1] = 0x8F;
+        clustered[i].id[5] = static_cast<uint8_t>(rng() % 4);
+        clustered[i].id[15] = static_cast<uint8_t>(rng() % 16);
+        clustered[i].original_pos = static_cast<int32_t>(i);
+    }
+    check("clustered prefix with duplicates (stable)", clustered, tiered::sort_order::ascending);
+    check("clustered prefix descending (stable)", clustered, tiered::sort_order::descending);
+
+    check("small input", std::vector<Event>(random.begin(), random.begin() + 50),
+          tiered::sort_order::ascending);
+
+    // Plain byte arrays with an identity key, non-16 width
+    {
+        std::vector<std::array<uint8_t, 5>> keys(N);
+        for (auto& k : keys) for (auto& b : k) b = static_cast<uint8_t>(rng() % 3);
+        auto expected = keys;
+        std::sort(expected.begin(), expected.end());
+        tiered::sort_by_byte_key(keys.begin(), keys.end(),
+            [](const std::array<uint8_t, 5>& k) { return k; });
+        report("5-byte identity keys", keys == expected);
+    }
+
+    // Wide keys where every level splits off one element: element i has a
+    // single 1 at byte i, so the stack must not grow with the key width
+    {
+        constexpr size_t W = 2560;
+        const size_t n = 2500;
+        std::vector<std::array<uint8_t, W>> wide(n);
+        std::vector<uint32_t> order(n);
+        for (size_t i = 0; i < n; i++) {
+            wide[i].fill(0);
+            wide[i][i] = 1;
+            order[i] = static_cast<uint32_t>(i);
+        }
+        std::shuffle(order.begin(), order.end(), rng);
+        tiered::sort_by_byte_key(order.begin(), order.end(),
+            [&wide](uint32_t i) -> const std::array<uint8_t, W>& { return wide[i]; });
+        bool ok = true;
+        for (size_t i = 0; i < n; i++) ok = ok && order[i] == n - 1 - i;
+        report("2560-byte keys, one element split off per level", ok);
+    }
+}
+
+// =============================================================================
+// 16-bit Float Tests (bfloat16, _Float16)
+// =============================================================================
+
+template<typename T>
+uint16_t half_bits(T v) {
+    uint16_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+template<typename T>
+void check_half(const std::string& name, std::vector<T> data, float (*to_float)(T),
+                tiered::sort_order order = tiered::sort_order::ascending) {
+    bool descending = order == tiered::sort_order::descending;
+
+    // Expected: stable sort by the radix key; compare bit patterns
+    auto expected = data;
+    std::stable_sort(expected.begin(), expected.end(), [&](T a, T b) {
+        return descending ? tiered::detail::to_unsigned(b) < tiered::detail::to_unsigned(a)
+                          : tiered::detail::to_unsigned(a) < tiered::detail::to_unsigned(b);
+    });
+    tiered::sort(data.begin(), data.end(), order);
+
+    bool pass = true;
+    for (size_t i = 0; i < data.size(); i++) {
+        if (half_bits(data[i]) != half_bits(expected[i])) pass = false;
+        // Independently: numeric order for non-NaN values
+        if (i > 0) {
+            float a = to_float(data[i - 1]), b = to_float(data[i]);
+            if (a == a && b == b && (descending ? a < b : b < a)) pass = false;
+        }
+    }
+    report(name, pass);
+}
+
+template<typename T>
+void test_half_type(const std::string& type_name, T (*from_float)(float), float (*to_float)(T)) {
+    std::cout << "\n=== Testing " << type_name << " ===\n";
+
+    std::mt19937 rng(29);
+    std::normal_distribution<float> dist(0.0f, 100.0f);
+    auto gen = [&](size_t n) {
+        std::vector<T> v(n);
+        for (auto& x : v) x = from_float(dist(rng));
+        return v;
+    };
+
+    check_half<T>("100 random", gen(100), to_float);
+    check_half<T>("10000 random (radix)", gen(10000), to_float);
+    check_half<T>("100000 random (direct counting)", gen(100000), to_float);
+    check_half<T>("100000 random descending", gen(100000), to_float, tiered::sort_order::descending);
+    check_half<T>("10000 random descending", gen(10000), to_float, tiered::sort_order::descending);
+
+    // NaN / infinity / signed zero placement
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> order = {-nan, -inf, -1.0f, -0.0f, 0.0f, 1.0f, inf, nan};
+    for (size_t n : {size_t(100), size_t(1000), size_t(100000)}) {
+        std::vector<T> data(n);
+        for (size_t i = 0; i < n; i++) data[i] = from_float(order[(i * 5) % order.size()]);
+        tiered::sort(data.begin(), data.end());
+
+        bool pass = true;
+        size_t block = 0;
+        for (size_t i = 0; i < n; i++) {
+            while (block < order.size() && half_bits(data[i]) != half_bits(from_float(order[block]))) block++;
+            if (block == order.size()) pass = false;
+        }
+        report("special values order (" + std::to_string(n) + ")", pass);
+    }
+
+    // stable_sort shares the same paths
+    {
+        auto data = gen(100000);
+        auto expected = data;
+        tiered::sort(expected.begin(), expected.end());
+        tiered::stable_sort(data.begin(), data.end());
+        bool pass = true;
+        for (size_t i = 0; i < data.size(); i++) {
+            if (half_bits(data[i]) != half_bits(expected[i])) pass = false;
+        }
+        report("stable_sort 100000 random", pass);
+    }
+}
+
+void test_half_floats() {
+    test_half_type<tiered::bfloat16>("bfloat16",
+        [](float f) { return tiered::bfloat16::from_float(f); },
+        [](tiered::bfloat16 v) { return v.to_float(); });
+#ifdef TIEREDSORT_HAS_FLOAT16
+    test_half_type<_Float16>("_Float16",
+        [](float f) { return static_cast<_Float16>(f); },
+        [](_Float16 v) { return static_cast<float>(v); });
+#endif
+}
+
+// =============================================================================
+// String Sorting Tests
+// =============================================================================
+
+void check_strings(const std::string& name, std::vector<std::string> data) {
+    auto expected = data;
+    std::sort(expected.begin(), expected.end());
+    tiered::sort_strings(data.begin(), data.end());
+    report(name, data == expected);
+}
+
+void test_sort_strings() {
+    std::cout << "\n=== sort_strings Tests ===\n";
+
+    std::mt19937 rng(30);
+    auto random_string = [&](size_t min_len, size_t max_len, int alphabet) {
+        std::string s(min_len + rng() % (max_len - min_len + 1), ' ');
+        for (auto& c : s) c = static_cast<char>('a' + rng() % alphabet);
+        return s;
+    };
+
+    check_strings("empty", {});
+    check_strings("small", {"pear", "apple", "fig", "", "apple", "banana"});
+
+    std::vector<std::string> random(20000);
+    for (auto& str : random) str = random_string(0, 30, 26);
+    check_strings("20000 random", random);
+
+    // Long shared prefixes (URLs): exercises pass skipping and 8-byte recursion
+    std::vector<std::string> urls(20000);
+    for (auto& str : urls) {
+        str = "https://example.com/api/v1/users/" + std::to_string(rng() % 5000) +
+              "/items/" + random_string(0, 4, 3);
+    }
+    check_strings("20000 URLs with shared prefixes", urls);
+
+    // Prefix relationships and zero bytes: "ab" < "ab\0" < "ab\0\0" < "abc"
+    std::vector<std::string> prefixes;
+    for (int i = 0; i < 3000; i++) {
+        std::string base = random_string(0, 20, 2);
+        prefixes.push_back(base);
+        prefixes.push_back(base + std::string(1 + rng() % 10, '\0'));
+        prefixes.push_back(base + "a");
+    }
+    check_strings("prefixes and embedded zero bytes", prefixes);
+
+    // High bytes must sort as unsigned (like std::string)
+    std::vector<std::string> binary(10000);
+    for (auto& str : binary) {
+        str.resize(rng() % 12);
+        for (auto& c : str) c = static_cast<char>(rng());
+    }
+    check_strings("binary strings (bytes >= 0x80)", binary);
+
+    // Heavy duplication and equal lengths
+    std::vector<std::string> dups(20000);
+    for (auto& str : dups) str = "key_" + std::to_string(rng() % 10);
+    check_strings("20000 with 10 distinct", dups);
+
+    // Megabyte shared prefixes: tie resolution must not recurse per 8 bytes
+    {
+        std::string buffer = std::string(1 << 20, 'a') + "b";
+        std::vector<std::string_view> views;
+        for (size_t i = 0; i < 300; i++) {
+            views.push_back(std::string_view(buffer).substr(i * 7 % 300));
+        }
+        auto expected = views;
+        std::sort(expected.begin(), expected.end());
+        tiered::sort_strings(views.begin(), views.end());
+        report("300 views with 1 MB shared prefixes", views == expected);
+    }
+
+    // string_view input
+    {
+        std::vector<std::string_view> views(urls.begin(), urls.end());
+        auto expected = views;
+        std::sort(expected.begin(), expected.end());
+        tiered::sort_strings(views.begin(), views.end());
+        report("string_view input", views == expected);
+    }
+}
+
+// =============================================================================
+// Selection Tests (nth_element, partial_sort, top_k)
+// =============================================================================
+
+template<typename T>
+void check_selection(const std::string& name, const std::vector<T>& data) {
+    size_t n = data.size();
+    auto sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+    auto sorted_desc = sorted;
+    std::reverse(sorted_desc.begin(), sorted_desc.end());
+
+    bool pass = true;
+    for (size_t k : {size_t(0), n / 100, n / 2, n - 1}) {
+        for (auto order : {tiered::sort_order::ascending, tiered::sort_order::descending}) {
+            const auto& ref = order == tiered::sort_order::ascending ? sorted : sorted_desc;
+            bool desc = order == tiered::sort_order::descending;
+            auto before = [desc](const T& a, const T& b) { return desc ? b < a : a < b; };
+
+            // nth_element: value at k and partition around it
+            auto v = data;
+            tiered::nth_element(v.begin(), v.begin() + k, v.end(), order);
+            if (v[k] != ref[k]) pass = false;
+            for (size_t i = 0; i < k; i++) if (before(v[k], v[i])) pass = false;
+            for (size_t i = k + 1; i < n; i++) if (before(v[i], v[k])) pass = false;
+
+            // partial_sort: first k+1 elements sorted
+            v = data;
+            tiered::partial_sort(v.begin(), v.begin() + k + 1, v.end(), order);
+            if (!std::equal(v.begin(), v.begin() + k + 1, ref.begin())) pass = false;
+
+            // top_k: input untouched, output sorted in the requested order
+            auto input = data;
+            std::vector<T> out(k + 1);
+            auto end = tiered::top_k(input.begin(), input.end(), k + 1, out.begin(),
+                                     desc ? tiered::sort_order::descending : tiered::sort_order::ascending);
+            if (end != out.end() || input != data) pass = false;
+            if (!std::equal(out.begin(), out.end(), ref.begin())) pass = false;
+        }
+    }
+    report(name, pass);
+}
+
+void test_selection() {
+    std::cout << "\n=== Selection Tests (nth_element, partial_sort, top_k) ===\n";
+
+    check_selection<int32_t>("int32 random", generate_random<int32_t>(20000));
+    check_selection<int32_t>("int32 small", generate_random<int32_t>(100));
+    check_selection<int32_t>("int32 few unique", generate_few_unique<int32_t>(20000));
+    check_selection<int32_t>("int32 all same", generate_all_same<int32_t>(5000));
+    check_selection<uint64_t>("uint64 random", generate_random<uint64_t>(20000));
+    check_selection<int64_t>("int64 clustered high bytes", generate_dense<int64_t>(20000, 1000000, 1005000));
+    check_selection<float>("float random", generate_random<float>(20000));
+    check_selection<double>("double random", generate_random<double>(20000));
+    check_selection<uint8_t>("uint8 random", generate_random_small<uint8_t>(20000));
+    check_selection<int16_t>("int16 random", generate_random_small<int16_t>(20000));
+
+    // Large input: top 1000 of 1M, boundary bucket path
+    {
+        auto data = generate_random<float>(1000000, 31);
+        std::vector<float> best(1000);
+        tiered::top_k(data.begin(), data.end(), best.size(), best.begin());
+        std::sort(data.begin(), data.end(), std::greater<float>());
+        report("top 1000 of 1M floats", std::equal(best.begin(), best.end(), data.begin()));
+    }
+
+    // Periodic data that fools the strided sample: must fall back correctly
+    {
+        const size_t n = 1 << 20;
+        std::vector<int64_t> data(n);
+        std::mt19937 rng(99);
+        for (size_t i = 0; i < n; i++) {
+            data[i] = (i % (n / 1024) == 0) ? 1000000000 + static_cast<int64_t>(i)
+                                            : static_cast<int64_t>(rng() % 1000000);
+        }
+        std::vector<int64_t> best(2000);
+        tiered::top_k(data.begin(), data.end(), best.size(), best.begin());
+        std::sort(data.begin(), data.end(), std::greater<int64_t>());
+        report("top_k on periodic data (sample fallback)", std::equal(best.begin(), best.end(), data.begin()));
+    }
+
+    // k larger than the input is clamped
+    {
+        std::vector<int32_t> data = {5, 1, 4};
+        std::vector<int32_t> out(10, -1);
+        auto end = tiered::top_k(data.begin(), data.end(), 10, out.begin());
+        report("top_k clamps k", end - out.begin() == 3 && out[0] == 5 && out[1] == 4 && out[2] == 1);
+    }
+}
+
+template<typename T>
+void check_quantiles(const std::string& name, const std::vector<T>& data) {
+    const std::vector<double> qs = {0.0, 0.25, 0.5, 0.9, 0.99, 0.999, 1.0, 0.5};
+    std::vector<T> copy = data;
+    std::vector<T> got(qs.size());
+    auto end = tiered::quantiles(copy.begin(), copy.end(), qs, got.begin());
+
+    std::vector<T> sorted = data;
+    tiered::sort(sorted.begin(), sorted.end());
+    bool ok = end == got.end() && copy == data;
+    for (size_t j = 0; j < qs.size() && ok; j++) {
+        size_t rank = static_cast<size_t>(qs[j] * static_cast<double>(sorted.size() - 1) + 0.5);
+        ok = std::memcmp(&got[j], &sorted[rank], sizeof(T)) == 0;
+    }
+    report(name, ok);
+}
+
+void test_quantiles() {
+    std::cout << "\n=== Quantile Tests ===\n";
+
+    check_quantiles<int32_t>("int32 random", generate_random<int32_t>(100000));
+    check_quantiles<int32_t>("int32 small", generate_random<int32_t>(50));
+    check_quantiles<int32_t>("int32 few unique", generate_few_unique<int32_t>(100000));
+    check_quantiles<int32_t>("int32 all same", generate_all_same<int32_t>(100000));
+    check_quantiles<uint32_t>("uint32 random", generate_random<uint32_t>(100000));
+    check_quantiles<int64_t>("int64 clustered high bytes", generate_dense<int64_t>(100000, 1000000, 1050000));
+    check_quantiles<uint64_t>("uint64 random", generate_random<uint64_t>(100000));
+    check_quantiles<float>("float random", generate_random<float>(100000));
+    check_quantiles<double>("double random", generate_random<double>(100000));
+    check_quantiles<uint8_t>("uint8 random", generate_random_small<uint8_t>(100000));
+    check_quantiles<int16_t>("int16 random", generate_random_small<int16_t>(100000));
+
+    // Long-tailed latencies: a few huge outliers
+    {
+        auto data = generate_random<double>(200000, 7);
+        for (auto& v : data) v = std::abs(v) * 1e-3;
+        for (size_t i = 0; i < data.size(); i += 997) data[i] = 1e6 + static_cast<double>(i);
+        check_quantiles<double>("double long tail", data);
+    }
+
+    // Empty input writes nothing
+    {
+        std::vector<int32_t> empty;
+        std::vector<int32_t> out(2, -1);
+        auto end = tiered::quantiles(empty.begin(), empty.end(), std::vector<double>{0.5, 0.9}, out.begin());
+        report("empty input", end == out.begin() && out[0] == -1);
+    }
+}
+
+template<typename T>
+void check_sort_unique(const std::string& name, const std::vector<T>& data) {
+    auto same = [](const T& a, const T& b) { return std::memcmp(&a, &b, sizeof(T)) == 0; };
+
+    // Reference: sort, then run-length encode by bit pattern
+    std::vector<T> sorted = data;
+    tiered::sort(sorted.begin(), sorted.end());
+    std::vector<T> ref_values;
+    std::vector<size_t> ref_counts;
+    for (const T& v : sorted) {
+        if (!ref_values.empty() && same(ref_values.back(), v)) {
+            ref_counts.back()++;
+        } else {
+            ref_values.push_back(v);
+            ref_counts.push_back(1);
+        }
+    }
+    auto equal_values = [&](const std::vector<T>& a, const std::vector<T>& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), same);
+    };
+
+    std::vector<T> u = data;
+    u.erase(tiered::sort_unique(u.begin(), u.end()), u.end());
+    bool ok = equal_values(u, ref_values);
+
+    std::vector<T> values, copy = data;
+    std::vector<size_t> counts;
+    tiered::sort_count(copy.begin(), copy.end(), std::back_inserter(values), std::back_inserter(counts));
+    ok = ok && equal_values(values, ref_values) && counts == ref_counts;
+
+    // Descending emits the same runs reversed
+    std::vector<T> ud = data;
+    ud.erase(tiered::sort_unique(ud.begin(), ud.end(), tiered::sort_order::descending), ud.end());
+    std::reverse(ud.begin(), ud.end());
+    ok = ok && equal_values(ud, ref_values);
+
+    values.clear();
+    counts.clear();
+    copy = data;
+    tiered::sort_count(copy.begin(), copy.end(), std::back_inserter(values), std::back_inserter(counts),
+                       tiered::sort_order::descending);
+    std::reverse(values.begin(), values.end());
+    std::reverse(counts.begin(), counts.end());
+    ok = ok && equal_values(values, ref_values) && counts == ref_counts;
+
+    report(name, ok);
+}
+
+void test_sort_unique() {
+    std::cout << "\n=== Sort Unique / Sort Count Tests ===\n";
+
+    check_sort_unique<int32_t>("int32 random (radix)", generate_random<int32_t>(100000));
+    check_sort_unique<int32_t>("int32 dense (counting)", generate_dense<int32_t>(100000, -500, 500));
+    check_sort_unique<int32_t>("int32 small", generate_random<int32_t>(100));
+    check_sort_unique<int32_t>("int32 sorted (pattern)", generate_sorted<int32_t>(10000));
+    check_sort_unique<int32_t>("int32 all same", generate_all_same<int32_t>(10000));
+    check_sort_unique<uint32_t>("uint32 few unique", generate_few_unique<uint32_t>(100000));
+    check_sort_unique<int64_t>("int64 random", generate_random<int64_t>(100000));
+    check_sort_unique<uint64_t>("uint64 random", generate_random<uint64_t>(100000));
+    check_sort_unique<float>("float random", generate_random<float>(100000));
+    check_sort_unique<double>("double few unique", generate_few_unique<double>(100000));
+    check_sort_unique<uint8_t>("uint8 random", generate_random_small<uint8_t>(100000));
+    check_sort_unique<int16_t>("int16 random (direct)", generate_random_small<int16_t>(100000));
+    check_sort_unique<int16_t>("int16 random (radix)", generate_random_small<int16_t>(5000));
+    {
+        // Below the direct-counting size: few values spread over the range
+        std::vector<int16_t> spread(5000);
+        for (size_t i = 0; i < spread.size(); i++) spread[i] = static_cast<int16_t>((i * 7919 % 12) * 5000 - 30000);
+        check_sort_unique<int16_t>("int16 few spread values (few distinct)", spread);
+    }
+
+    // 8-bit direct counting keeps its histogram on the stack, as sort does
+    {
+        std::vector<uint8_t> data = generate_random_small<uint8_t>(100000);
+        size_t before = heap_allocations;
+        auto end = tiered::sort_unique(data.begin(), data.end());
+        size_t allocations = heap_allocations - before;
+        report("uint8 sort_unique allocation-free", allocations == 0 && end - data.begin() == 256);
+    }
+
+    // Duplicates that straddle radix buckets
+    {
+        std::vector<uint64_t> data;
+        for (int i = 0; i < 3000; i++) {
+            data.push_back(uint64_t(i) << 40);
+            data.push_back(uint64_t(i) << 40);
+        }
+        std::vector<uint64_t> u = data;
+        u.erase(tiered::sort_unique(u.begin(), u.end()), u.end());
+        report("uint64 duplicated sparse keys", u.size() == 3000 && std::is_sorted(u.begin(), u.end()));
+    }
+
+    // Signed zeros interleaved: the comparison tiers must keep each bit
+    // pattern in one run
+    {
+        std::vector<float> small = {-0.f, 0.f, -0.f, 0.f, 1.f};
+        std::vector<float> u = small;
+        u.erase(tiered::sort_unique(u.begin(), u.end()), u.end());
+        std::vector<float> values;
+        std::vector<size_t> counts;
+        tiered::sort_count(small.begin(), small.end(), std::back_inserter(values), std::back_inserter(counts));
+        report("float signed zeros, small",
+               u.size() == 3 && std::signbit(u[0]) && !std::signbit(u[1]) && u[2] == 1.f &&
+               values.size() == 3 && counts == std::vector<size_t>({2, 2, 1}));
+    }
+    {
+        // Non-decreasing by value (pattern tier): 150 negatives, 300
+        // alternating -0.0/0.0, 150 positives
+        std::vector<double> data(600);
+        for (size_t i = 0; i < data.size(); i++) {
+            if (i < 150) data[i] = static_cast<double>(i) - 150.0;
+            else if (i < 450) data[i] = i % 2 ? 0.0 : -0.0;
+            else data[i] = static_cast<double>(i - 449);
+        }
+        std::vector<double> u = data;
+        u.erase(tiered::sort_unique(u.begin(), u.end()), u.end());
+        std::vector<double> values;
+        std::vector<size_t> counts;
+        std::vector<double> copy = data;
+        tiered::sort_count(copy.begin(), copy.end(), std::back_inserter(values), std::back_inserter(counts),
+                           tiered::sort_order::descending);
+        report("double signed zeros, pattern-sorted",
+               u.size() == 302 && std::signbit(u[150]) && !std::signbit(u[151]) &&
+               values.size() == 302 && counts[150] == 150 && counts[151] == 150 &&
+               !std::signbit(values[150]) && std::signbit(values[151]));
+    }
+}
+
+// Bit-exact comparison: tells -0.0 from 0.0
+template<typename T>
+bool same_bits(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// Expected float order of the radix tier: by sortable key, -0.0 before 0.0
+template<typename T>
+std::vector<T> key_sorted(std::vector<T> data) {
+    std::sort(data.begin(), data.end(), tiered::detail::sortable_key_less<T, false>());
+    return data;
+}
+
+template<typename T>
+void check_few_distinct(const std::string& name, const std::vector<T>& data) {
+    std::vector<T> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<T> a = data;
+    tiered::sort(a.begin(), a.end());
+    std::vector<T> b = data;
+    tiered::stable_sort(b.begin(), b.end());
+    std::vector<T> c = data;
+    std::vector<T> buffer(c.size());
+    tiered::sort(c.begin(), c.end(), buffer.data());
+    std::vector<T> d = data;
+    tiered::sort(d.begin(), d.end(), tiered::sort_order::descending);
+    std::reverse(d.begin(), d.end());
+
+    report(name, a == expected && b == expected && c == expected && d == expected);
+}
+
+void test_few_distinct() {
+    std::cout << "\n=== Few Distinct Values Tests (Tier 3b) ===\n";
+
+    const size_t n = 100000;
+    std::mt19937_64 rng(7);
+
+    // 20 enum ids spread over the whole int64 space
+    {
+        std::vector<int64_t> ids(20);
+        for (auto& id : ids) id = static_cast<int64_t>(rng());
+        std::vector<int64_t> data(n);
+        for (auto& v : data) v = ids[rng() % ids.size()];
+        check_few_distinct("int64 sparse enum ids", data);
+    }
+
+    // Status codes mixed with sentinels
+    {
+        const int32_t codes[] = {200, 200, 200, 404, 500, 301, -1, 2147483647};
+        std::vector<int32_t> data(n);
+        for (auto& v : data) v = codes[rng() % 8];
+        check_few_distinct("int32 status codes + sentinels", data);
+    }
+
+    // Exactly the table capacity, and one more (falls back to radix)
+    for (size_t distinct : {size_t(64), size_t(65)}) {
+        std::vector<uint64_t> data(n);
+        for (size_t i = 0; i < n; i++) data[i] = (i % distinct) * 0x9E3779B97F4A7C15ull;
+        std::shuffle(data.begin(), data.end(), rng);
+        check_few_distinct("uint64 " + std::to_string(distinct) + " distinct", data);
+    }
+
+    // Rare values the sample cannot see
+    {
+        std::vector<uint32_t> data(n, 0xDEADBEEFu);
+        data[12345] = 7;
+        data[n - 1] = 0xFFFFFFFFu;
+        check_few_distinct("uint32 values missed by the sample", data);
+    }
+
+    // Floats keep their exact bit patterns (signed zeros)
+    {
+        const float values[] = {-0.0f, 0.0f, 1e30f, -1e30f, 3.5f};
+        std::vector<float> data(n);
+        for (auto& v : data) v = values[rng() % 5];
+        std::vector<float> a = data;
+        tiered::sort(a.begin(), a.end());
+        bool ok = std::is_sorted(a.begin(), a.end());
+        for (size_t i = 1; i < a.size() && ok; i++) {
+            ok = !(a[i] == 0.0f && a[i - 1] == 0.0f && std::signbit(a[i]) && !std::signbit(a[i - 1]));
+        }
+        report("float few distinct with signed zeros", ok);
+    }
+
+    {
+        std::vector<int64_t> data(n);
+        for (auto& v : data) v = static_cast<int64_t>(rng() % 10) << 50;
+        std::vector<int64_t> values;
+        std::vector<size_t> counts;
+        tiered::sort_count(data.begin(), data.end(), std::back_inserter(values), std::back_inserter(counts));
+        size_t total = 0;
+        for (size_t c : counts) total += c;
+        report("sort_count on sparse few distinct", values.size() == 10 && total == n &&
+               std::is_sorted(values.begin(), values.end()));
+    }
+}
+
+void test_heavy_hitters() {
+    std::cout << "\n=== Heavy Hitter Tests (Tier 3c) ===\n";
+
+    const size_t n = 200000;
+    std::mt19937_64 rng(11);
+
+    // Zipf-like: a few hashed ids take most of the mass, long sparse tail
+    {
+        std::vector<uint64_t> data(n);
+        for (auto& v : data) {
+            uint64_t r = rng() % 100;
+            uint64_t rank = r < 60 ? r % 6 : rng() % 1000000;
+            v = (rank + 1) * 0x9E3779B97F4A7C15ull;
+        }
+        check_few_distinct("uint64 zipf-like ids", data);
+    }
+
+    // Heavy values at both ends of the key range and in the middle
+    {
+        std::vector<int32_t> data(n);
+        for (auto& v : data) {
+            switch (rng() % 5) {
+                case 0: v = std::numeric_limits<int32_t>::min(); break;
+                case 1: v = std::numeric_limits<int32_t>::max(); break;
+                case 2: v = 0; break;
+                default: v = static_cast<int32_t>(rng());
+            }
+        }
+        check_few_distinct("int32 heavy extremes + random tail", data);
+    }
+
+    // Tail smaller than the radix threshold
+    {
+        std::vector<int64_t> data(n);
+        for (size_t i = 0; i < n; i++) data[i] = (i % 1000 == 0) ? static_cast<int64_t>(rng()) : int64_t(i % 3) << 40;
+        check_few_distinct("int64 tiny tail", data);
+    }
+
+    // Floats with heavy signed zeros
+    {
+        std::vector<double> data(n);
+        for (auto& v : data) {
+            uint64_t r = rng() % 4;
+            v = r == 0 ? -0.0 : r == 1 ? 0.0 : static_cast<double>(rng() % 1000000) * 0.25;
+        }
+        std::vector<double> a = data;
+        tiered::sort(a.begin(), a.end());
+        bool ok = std::is_sorted(a.begin(), a.end());
+        size_t neg = 0, pos = 0;
+        for (size_t i = 0; i < a.size() && ok; i++) {
+            if (a[i] == 0.0) {
+                if (std::signbit(a[i])) {
+                    ok = pos == 0;
+                    neg++;
+                } else {
+                    pos++;
+                }
+            }
+        }
+        report("double heavy signed zeros", ok && neg > 0 && pos > 0);
+    }
+
+    // Short tail of signed zeros spliced between heavy fractional values
+    {
+        std::vector<double> data(n);
+        for (size_t i = 0; i < n; i++) {
+            data[i] = i % 1000 == 0 ? (i % 3000 == 0 ? -0.0 : i % 3000 == 1000 ? 0.0 : -0.125)
+                                    : static_cast<double>(i % 4) - 1.5;
+        }
+        std::vector<double> expected = key_sorted(data);
+        std::vector<double> a = data;
+        bool took = tiered::detail::heavy_hitter_sort<double, false>(a.data(), n, nullptr);
+        std::vector<double> d = data;
+        took = took && tiered::detail::heavy_hitter_sort<double, true>(d.data(), n, nullptr);
+        std::reverse(d.begin(), d.end());
+        report("double short tail of signed zeros", took && same_bits(a, expected) && same_bits(d, expected));
+    }
+}
+
+void test_dense_detection() {
+    std::cout << "\n=== Dense Range Detection Tests ===\n";
+
+    const size_t n = 1 << 20;
+    std::mt19937 rng(3);
+
+    // Every (n/64)-th element in a narrow band: a fixed-stride sample would
+    // call this dense
+    {
+        std::vector<int32_t> data(n);
+        for (size_t i = 0; i < n; i++) {
+            data[i] = (i % (n / 64) == 0) ? static_cast<int32_t>(i / (n / 64)) : static_cast<int32_t>(rng());
+        }
+        tiered::detail::dense_histogram<int32_t> hist;
+        bool dense = tiered::detail::build_dense_histogram(data.data(), n, hist);
+        std::vector<int32_t> expected = data;
+        std::sort(expected.begin(), expected.end());
+        tiered::sort(data.begin(), data.end());
+        report("periodic data rejected", !dense && data == expected);
+    }
+
+    // Dense except for one far outlier at the very end
+    {
+        std::vector<int64_t> data(n);
+        for (auto& v : data) v = static_cast<int64_t>(rng() % n);
+        data[n - 1] = int64_t(1) << 40;
+        tiered::detail::dense_histogram<int64_t> hist;
+        bool dense = tiered::detail::build_dense_histogram(data.data(), n, hist);
+        std::vector<int64_t> expected = data;
+        std::sort(expected.begin(), expected.end());
+        tiered::sort(data.begin(), data.end());
+        report("late outlier rejected", !dense && data == expected);
+    }
+
+    // Dense data reports its exact bounds
+    {
+        std::vector<int32_t> data = generate_dense<int32_t>(n, -1000, 500000);
+        data[n / 3] = -1000;
+        data[n / 2] = 500000;
+        tiered::detail::dense_histogram<int32_t> hist;
+        bool dense = tiered::detail::build_dense_histogram(data.data(), n, hist);
+        report("dense data exact bounds", dense && hist.value(hist.lo) == -1000 && hist.value(hist.hi) == 500000 &&
+               hist.count[hist.lo] >= 1 && hist.count[hist.hi] >= 1);
+    }
+
+    // Values outside the sampled window force a rebase mid-scan
+    {
+        std::vector<int32_t> data(n);
+        for (size_t i = 0; i < n; i++) data[i] = static_cast<int32_t>(rng() % 1000);
+        data[5] = -400000;
+        data[n - 7] = 600000;
+        tiered::detail::dense_histogram<int32_t> hist;
+        bool dense = tiered::detail::build_dense_histogram(data.data(), n, hist);
+        size_t total = 0;
+        for (size_t b = 0; b < hist.cap; b++) total += hist.count[b];
+        bool ok = dense && total == n && hist.value(hist.lo) == -400000 && hist.value(hist.hi) == 600000;
+
+        std::vector<int32_t> expected = data;
+        std::sort(expected.begin(), expected.end());
+        std::vector<int32_t> a = data;
+        tiered::sort(a.begin(), a.end());
+        std::vector<int32_t> b = data;
+        tiered::stable_sort(b.begin(), b.end(), tiered::sort_order::descending);
+        std::reverse(b.begin(), b.end());
+        report("out-of-window values rebase the histogram", ok && a == expected && b == expected);
+    }
+
+    // Run lengths around the short-run block size, ending at the array end
+    {
+        bool ok = true;
+        for (size_t len : {size_t(7), size_t(8), size_t(9), size_t(40)}) {
+            std::vector<int32_t> data;
+            for (int32_t v = 0; v < 300; v++) {
+                size_t run = (v % 3 == 0) ? 0 : (v % 3 == 1 ? 1 : len);
+                data.insert(data.end(), run, v);
+            }
+            std::shuffle(data.begin(), data.end(), rng);
+            std::vector<int32_t> expected = data;
+            std::sort(expected.begin(), expected.end());
+            std::vector<int32_t> a = data;
+            tiered::sort(a.begin(), a.end());
+            std::vector<int32_t> d = data;
+            tiered::sort(d.begin(), d.end(), tiered::sort_order::descending);
+            std::reverse(d.begin(), d.end());
+            ok = ok && a == expected && d == expected;
+        }
+        report("counting output with short and long runs", ok);
+    }
+
+    // Rebase near the top of the unsigned key space
+    {
+        std::vector<uint64_t> data(n);
+        const uint64_t top = std::numeric_limits<uint64_t>::max();
+        for (size_t i = 0; i < n; i++) data[i] = top - rng() % 1000;
+        data[n / 2] = top - 1500000;
+        std::vector<uint64_t> expected = data;
+        std::sort(expected.begin(), expected.end());
+        tiered::sort(data.begin(), data.end());
+        report("uint64 dense at the top of the range", data == expected);
+    }
+}
+
+void test_integral_floats() {
+    std::cout << "\n=== Integral-Valued Float Tests ===\n";
+
+    const size_t n = 1 << 18;
+    std::mt19937 rng(11);
+
+    // Prices in cents: whole-number doubles in a dense range
+    {
+        std::vector<double> data(n);
+        for (auto& v : data) v = static_cast<double>(rng() % n) - 1000.0;
+        tiered::detail::dense_histogram<double> hist;
+        bool dense = tiered::detail::build_dense_histogram(data.data(), n, hist);
+        std::vector<double> expected = key_sorted(data);
+        std::vector<double> a = data;
+        tiered::sort(a.begin(), a.end());
+        std::vector<double> b = data;
+        tiered::stable_sort(b.begin(), b.end());
+        std::vector<double> d = data;
+        tiered::sort(d.begin(), d.end(), tiered::sort_order::descending);
+        std::reverse(d.begin(), d.end());
+        std::vector<double> buffer(n);
+        std::vector<double> c = data;
+        tiered::sort(c.begin(), c.end(), buffer.data());
+        report("whole-number doubles use the dense tier", dense && same_bits(a, expected) && same_bits(b, expected) &&
+               same_bits(d, expected) && same_bits(c, expected));
+    }
+
+    // Negative whole-number floats
+    {
+        std::vector<float> data(n);
+        for (auto& v : data) v = static_cast<float>(-static_cast<int32_t>(rng() % 5000));
+        data[n / 2] = 1.0f;
+        tiered::detail::dense_histogram<float> hist;
+        bool dense = tiered::detail::build_dense_histogram(data.data(), n, hist);
+        std::vector<float> expected = key_sorted(data);
+        std::vector<float> a = data;
+        tiered::stable_sort(a.begin(), a.end(), tiered::sort_order::descending);
+        std::reverse(a.begin(), a.end());
+        report("whole-number floats use the dense tier", dense && hist.value(hist.hi) == 1.0f && same_bits(a, expected));
+    }
+
+    // Values the integer keys cannot represent send the array to radix sort
+    {
+        bool ok = true;
+        for (double odd : {-0.0, 0.5, std::numeric_limits<double>::quiet_NaN(), 1e300}) {
+            std::vector<double> data(n);
+            for (auto& v : data) v = static_cast<double>(rng() % 1000);
+            data[n - 3] = odd;
+            tiered::detail::dense_histogram<double> hist;
+            bool dense = tiered::detail::build_dense_histogram(data.data(), n, hist);
+            std::vector<double> expected = key_sorted(data);
+            std::vector<double> a = data;
+            tiered::sort(a.begin(), a.end());
+            std::vector<double> b = data;
+            tiered::stable_sort(b.begin(), b.end());
+            ok = ok && !dense && same_bits(a, expected) && same_bits(b, expected);
+        }
+        report("-0.0, fractions, NaN and huge values rejected", ok);
+    }
+
+    // sort_unique reads the distinct values straight off the histogram
+    {
+        std::vector<double> data(n);
+        for (auto& v : data) v = static_cast<double>(rng() % (n / 4));
+        std::vector<double> expected = key_sorted(data);
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+        data.erase(tiered::sort_unique(data.begin(), data.end()), data.end());
+        report("sort_unique on whole-number doubles", same_bits(data, expected));
+    }
+}
+
+// Inputs that reach every tier: small, sorted, dense (large histogram),
+// dense with a rebase, few distinct, heavy hitters, random
+template<typename T>
+std::vector<std::vector<T>> tier_inputs(std::mt19937_64& rng, size_t n) {
+    std::vector<std::vector<T>> inputs;
+    inputs.emplace_back(100);
+    inputs.emplace_back(n);
+    inputs.emplace_back(n);
+    inputs.emplace_back(n);
+    inputs.emplace_back(n);
+    inputs.emplace_back(n);
+    inputs.emplace_back(n);
+    for (auto& v : inputs[0]) v = static_cast<T>(rng());
+    for (size_t i = 0; i < n; i++) inputs[1][i] = static_cast<T>(i);
+    for (auto& v : inputs[2]) v = static_cast<T>(rng() % n);
+    for (auto& v : inputs[3]) v = static_cast<T>(rng() % 1000);
+    inputs[3][3] = static_cast<T>(n / 2);
+    for (auto& v : inputs[4]) v = static_cast<T>((rng() % 20) * 1000003);
+    for (auto& v : inputs[5]) v = static_cast<T>(rng() % 4 == 0 ? rng() : rng() % 8);
+    for (auto& v : inputs[6]) v = static_cast<T>(rng());
+    return inputs;
+}
+
+struct Keyed {
+    int32_t key;
+    uint32_t payload;
+};
+
+void test_sorter() {
+    std::cout << "\n=== Reusable Sorter Tests ===\n";
+
+    std::mt19937_64 rng(37);
+    const size_t n = 1 << 17;
+
+    // Same results as the free functions, and no allocations once warm
+    {
+        auto inputs = tier_inputs<uint32_t>(rng, n);
+        std::vector<std::vector<uint32_t>> expected = inputs;
+        for (auto& e : expected) std::sort(e.begin(), e.end());
+        tiered::sorter<uint32_t> s;
+        std::vector<uint32_t> work;
+        work.reserve(n);
+        bool ok = true;
+        size_t allocations = 0;
+        for (int round = 0; round < 2; round++) {
+            size_t before = heap_allocations;
+            for (size_t i = 0; i < inputs.size(); i++) {
+                const auto& e = expected[i];
+                work.assign(inputs[i].begin(), inputs[i].end());
+                s.sort(work.begin(), work.end());
+                ok = ok && work == e;
+                work.assign(inputs[i].begin(), inputs[i].end());
+                s.sort(work.begin(), work.end(), tiered::sort_order::descending);
+                ok = ok && std::equal(work.begin(), work.end(), e.rbegin());
+                work.assign(inputs[i].begin(), inputs[i].end());
+                s.stable_sort(work.begin(), work.end());
+                ok = ok && work == e;
+                work.assign(inputs[i].begin(), inputs[i].end());
+                s.stable_sort(work.begin(), work.end(), tiered::sort_order::descending);
+                ok = ok && std::equal(work.begin(), work.end(), e.rbegin());
+            }
+            allocations = heap_allocations - before;
+        }
+        report("uint32 sort/stable_sort: every tier, no allocations when warm", ok && allocations == 0);
+    }
+
+    // 16-bit direct counting and float tiers
+    {
+        std::vector<uint16_t> shorts(1 << 17);
+        for (auto& v : shorts) v = static_cast<uint16_t>(rng());
+        std::vector<double> doubles(n);
+        for (auto& v : doubles) v = static_cast<double>(rng() % n) / 4.0;
+        tiered::sorter<uint16_t> s16;
+        tiered::sorter<double> sd;
+        std::vector<uint16_t> w16;
+        std::vector<double> wd;
+        w16.reserve(shorts.size());
+        wd.reserve(doubles.size());
+        size_t allocations = 0;
+        bool ok = true;
+        for (int round = 0; round < 2; round++) {
+            size_t before = heap_allocations;
+            w16.assign(shorts.begin(), shorts.end());
+            s16.stable_sort(w16.begin(), w16.end());
+            wd.assign(doubles.begin(), doubles.end());
+            sd.sort(wd.begin(), wd.end());
+            ok = ok && std::is_sorted(w16.begin(), w16.end()) && std::is_sorted(wd.begin(), wd.end());
+            allocations = heap_allocations - before;
+        }
+        report("uint16 and double sorters allocation-free when warm", ok && allocations == 0);
+    }
+
+    // sort_by_key: stable on every path, no allocations when warm
+    {
+        std::vector<std::vector<Keyed>> inputs(4);
+        inputs[0].resize(200);
+        inputs[1].resize(n);
+        inputs[2].resize(n);
+        inputs[3].resize(n);
+        for (auto& in : inputs) {
+            for (size_t i = 0; i < in.size(); i++) in[i].payload = static_cast<uint32_t>(i);
+        }
+        for (auto& r : inputs[0]) r.key = static_cast<int32_t>(rng() % 50);
+        for (size_t i = 0; i < n; i++) inputs[1][i].key = static_cast<int32_t>(i / 3);
+        for (auto& r : inputs[2]) r.key = static_cast<int32_t>(rng() % 5000);
+        for (auto& r : inputs[3]) r.key = static_cast<int32_t>(rng());
+
+        tiered::sorter<Keyed> s;
+        std::vector<Keyed> work;
+        work.reserve(n);
+        auto key = [](const Keyed& r) { return r.key; };
+        bool ok = true;
+        size_t allocations = 0;
+        for (int round = 0; round < 2; round++) {
+            size_t before = heap_allocations;
+            for (const auto& in : inputs) {
+                work.assign(in.begin(), in.end());
+                s.sort_by_key(work.begin(), work.end(), key, tiered::sort_order::descending);
+                ok = ok && std::is_sorted(work.begin(), work.end(), [](const Keyed& a, const Keyed& b) {
+                    return b.key < a.key || (a.key == b.key && a.payload < b.payload);
+                });
+            }
+            allocations = heap_allocations - before;
+        }
+        report("sort_by_key stable and allocation-free when warm", ok && allocations == 0);
+    }
+}
+
+#ifdef TIEREDSORT_HAS_PMR
+// Resource that counts its traffic; backed by malloc so it never shows up
+// in heap_allocations
+class counting_resource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t live_bytes = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t) override {
+        allocations++;
+        live_bytes += bytes;
+        if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+        throw std::bad_alloc();
+    }
+    void do_deallocate(void* p, size_t bytes, size_t) override {
+        live_bytes -= bytes;
+        std::free(p);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void test_memory_resource() {
+    std::cout << "\n=== Memory Resource Tests ===\n";
+
+    std::mt19937_64 rng(41);
+    const size_t n = 1 << 17;
+
+    // Every tier draws scratch from the resource only, and returns it
+    {
+        auto inputs = tier_inputs<uint32_t>(rng, n);
+        std::vector<std::vector<uint32_t>> expected = inputs;
+        for (auto& e : expected) std::sort(e.begin(), e.end());
+        std::vector<uint32_t> work;
+        work.reserve(n);
+        counting_resource res;
+        bool ok = true;
+        size_t before = heap_allocations;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            const auto& e = expected[i];
+            work.assign(inputs[i].begin(), inputs[i].end());
+            tiered::sort(work.begin(), work.end(), &res);
+            ok = ok && work == e;
+            work.assign(inputs[i].begin(), inputs[i].end());
+            tiered::sort(work.begin(), work.end(), &res, tiered::sort_order::descending);
+            ok = ok && std::equal(work.begin(), work.end(), e.rbegin());
+            work.assign(inputs[i].begin(), inputs[i].end());
+            tiered::stable_sort(work.begin(), work.end(), &res);
+            ok = ok && work == e;
+        }
+        size_t allocations = heap_allocations - before;
+        report("sort/stable_sort: scratch only from the resource",
+               ok && allocations == 0 && res.allocations > 0 && res.live_bytes == 0);
+    }
+
+    // 16-bit direct counting and dense doubles
+    {
+        std::vector<uint16_t> shorts(1 << 17);
+        for (auto& v : shorts) v = static_cast<uint16_t>(rng());
+        std::vector<double> doubles(n);
+        for (auto& v : doubles) v = static_cast<double>(rng() % n);
+        counting_resource res;
+        size_t before = heap_allocations;
+        tiered::sort(shorts.begin(), shorts.end(), &res);
+        tiered::stable_sort(doubles.begin(), doubles.end(), &res);
+        size_t allocations = heap_allocations - before;
+        report("uint16 and double scratch from the resource",
+               std::is_sorted(shorts.begin(), shorts.end()) && std::is_sorted(doubles.begin(), doubles.end()) &&
+               allocations == 0 && res.allocations > 0);
+    }
+
+    // sort_by_key: object buffer and count table from the resource, still stable
+    {
+        std::vector<Keyed> records(n);
+        for (size_t i = 0; i < n; i++) {
+            records[i].key = static_cast<int32_t>(rng() % 5000);
+            records[i].payload = static_cast<uint32_t>(i);
+        }
+        std::vector<Keyed> sparse(300);
+        for (size_t i = 0; i < sparse.size(); i++) {
+            sparse[i].key = static_cast<int32_t>(rng() % 7);
+            sparse[i].payload = static_cast<uint32_t>(i);
+        }
+        auto key = [](const Keyed& r) { return r.key; };
+        auto stable = [](const Keyed& a, const Keyed& b) {
+            return a.key < b.key || (a.key == b.key && a.payload < b.payload);
+        };
+        counting_resource res;
+        size_t before = heap_allocations;
+        tiered::sort_by_key(records.begin(), records.end(), key, &res);
+        tiered::sort_by_key(sparse.begin(), sparse.end(), key, &res);
+        size_t allocations = heap_allocations - before;
+        report("sort_by_key scratch from the resource",
+               std::is_sorted(records.begin(), records.end(), stable) &&
+               std::is_sorted(sparse.begin(), sparse.end(), stable) &&
+               allocations == 0 && res.live_bytes == 0);
+    }
+
+    // A fixed arena with no upstream: the radix sort fits in 2n elements
+    {
+        std::vector<uint64_t> data(1 << 16);
+        for (auto& v : data) v = rng();
+        std::vector<std::byte> arena(data.size() * sizeof(uint64_t) * 2);
+        std::pmr::monotonic_buffer_resource pool(arena.data(), arena.size(), std::pmr::null_memory_resource());
+        bool ok = true;
+        try {
+            tiered::sort(data.begin(), data.end(), &pool);
+        } catch (const std::bad_alloc&) {
+            ok = false;
+        }
+        report("sort within a fixed monotonic arena", ok && std::is_sorted(data.begin(), data.end()));
+    }
+
+    // sorter drawing its workspace from a resource
+    {
+        counting_resource res;
+        std::vector<Keyed> records(n);
+        for (size_t i = 0; i < n; i++) {
+            records[i].key = static_cast<int32_t>(rng() % 1000);
+            records[i].payload = static_cast<uint32_t>(i);
+        }
+        size_t before = heap_allocations;
+        {
+            tiered::sorter<Keyed> s(&res);
+            s.sort_by_key(records.begin(), records.end(), [](const Keyed& r) { return r.key; });
+        }
+        size_t allocations = heap_allocations - before;
+        report("sorter with a memory resource",
+               std::is_sorted(records.begin(), records.end(),
+                              [](const Keyed& a, const Keyed& b) { return a.key < b.key; }) &&
+               allocations == 0 && res.allocations > 0 && res.live_bytes == 0);
+    }
+
+    // sorter takes its temp buffer only once a tier needs it
+    {
+        counting_resource res;
+        tiered::sorter<uint32_t> s(&res);
+        std::vector<uint32_t> sorted_input(n), few(n), narrow(n), random(n);
+        for (size_t i = 0; i < n; i++) {
+            sorted_input[i] = static_cast<uint32_t>(i);
+            few[i] = static_cast<uint32_t>(rng() % 8) << 24;
+            narrow[i] = static_cast<uint32_t>(rng() % 1000);
+        }
+        for (auto& v : random) v = static_cast<uint32_t>(rng());
+        s.sort(sorted_input.begin(), sorted_input.end());
+        s.sort(few.begin(), few.end());
+        s.sort(narrow.begin(), narrow.end());
+        bool lazy = res.allocations == 0;
+        s.sort(random.begin(), random.end());
+        report("sorter takes no temp buffer for the counting tiers",
+               lazy && res.live_bytes >= n * sizeof(uint32_t) && std::is_sorted(few.begin(), few.end()) &&
+               std::is_sorted(narrow.begin(), narrow.end()) && std::is_sorted(random.begin(), random.end()));
+    }
+}
+#endif
+
+// Temp buffers past TIEREDSORT_HUGE_PAGE_MIN come from an aligned mapping
+// when built with TIEREDSORT_HUGE_PAGES
+void test_huge_pages() {
+    std::cout << "\n=== Huge Page Temp Buffer Tests ===\n";
+
+    std::mt19937_64 rng(43);
+    std::vector<uint32_t> data(TIEREDSORT_HUGE_PAGE_MIN / sizeof(uint32_t) + 1000);
+    for (auto& v : data) v = static_cast<uint32_t>(rng());
+    std::vector<uint32_t> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<uint32_t> work = data;
+    tiered::sort(work.begin(), work.end());
+    report("uint32 radix sort past the huge-page threshold", work == expected);
+    work = data;
+    tiered::stable_sort(work.begin(), work.end(), tiered::sort_order::descending);
+    report("uint32 stable descending past the huge-page threshold",
+           std::equal(work.begin(), work.end(), expected.rbegin()));
+
+#ifdef TIEREDSORT_HAS_HUGE_PAGES
+    tiered::detail::huge_page_block block;
+    auto* p = static_cast<unsigned char*>(block.map(3 * tiered::detail::HUGE_PAGE_BYTES + 1));
+    bool ok = p && reinterpret_cast<uintptr_t>(p) % tiered::detail::HUGE_PAGE_BYTES == 0;
+    if (p) {
+        std::memset(p, 0xAB, 3 * tiered::detail::HUGE_PAGE_BYTES + 1);
+        ok = ok && p[3 * tiered::detail::HUGE_PAGE_BYTES] == 0xAB;
+    }
+    report("huge_page_block is 2 MB aligned and writable", ok);
+#endif
+}
+
+// sort_bounded over budgets from nothing up to scratch_bytes_required:
+// same result as std::sort and never a heap allocation
+template<typename T>
+bool bounded_matches(const std::vector<std::vector<T>>& inputs) {
+    bool ok = true;
+    std::vector<unsigned char> scratch;
+    std::vector<T> work;
+    for (const auto& in : inputs) {
+        size_t n = in.size();
+        std::vector<T> expected = in;
+        std::sort(expected.begin(), expected.end());
+        size_t required = tiered::scratch_bytes_required<T>(n);
+        scratch.resize(required + 1);
+        work.reserve(n);
+        const size_t budgets[] = {0, 1000, n * sizeof(T) / 2, n * sizeof(T) + 64, required};
+        for (size_t budget : budgets) {
+            budget = std::min(budget, required);
+            work.assign(in.begin(), in.end());
+            size_t before = heap_allocations;
+            // Misaligned on purpose: the arena aligns its own blocks
+            tiered::sort_bounded(work.begin(), work.end(), scratch.data() + 1, budget);
+            ok = ok && heap_allocations == before && work == expected;
+            work.assign(in.begin(), in.end());
+            before = heap_allocations;
+            tiered::sort_bounded(work.begin(), work.end(), scratch.data() + 1, budget,
+                                 tiered::sort_order::descending);
+            ok = ok && heap_allocations == before && std::equal(work.begin(), work.end(), expected.rbegin());
+        }
+    }
+    return ok;
+}
+
+void test_sort_bounded() {
+    std::cout << "\n=== Bounded-Memory Sort Tests ===\n";
+
+    std::mt19937_64 rng(47);
+    const size_t n = 1 << 17;
+
+    report("uint32 every tier, any budget", bounded_matches(tier_inputs<uint32_t>(rng, n)));
+    report("int64 every tier, any budget", bounded_matches(tier_inputs<int64_t>(rng, n)));
+
+    {
+        std::vector<std::vector<uint16_t>> inputs(2);
+        inputs[0].resize(1 << 17);
+        inputs[1].resize(5000);
+        for (auto& in : inputs) for (auto& v : in) v = static_cast<uint16_t>(rng());
+        report("uint16 direct counting and radix, any budget", bounded_matches(inputs));
+    }
+    {
+        std::vector<std::vector<double>> inputs(2);
+        inputs[0].resize(n);
+        inputs[1].resize(n);
+        for (auto& v : inputs[0]) v = static_cast<double>(rng() % n) - 5000.0;
+        for (auto& v : inputs[1]) v = static_cast<double>(static_cast<int64_t>(rng())) / 7.0;
+        report("double dense and random, any budget", bounded_matches(inputs));
+    }
+#ifdef TIEREDSORT_HAS_INT128
+    {
+        using i128 = tiered::detail::int128;
+        std::vector<std::vector<i128>> inputs(1);
+        inputs[0].resize(20000);
+        using u128 = tiered::detail::uint128;
+        for (auto& v : inputs[0]) v = static_cast<i128>((u128(rng()) << 64) | rng());
+        report("int128 radix and in-place MSD", bounded_matches(inputs));
+    }
+#endif
+
+    // The dense tier's rebase table counts toward the bound
+    size_t required = tiered::scratch_bytes_required<uint32_t>(n);
+    size_t stable = tiered::scratch_bytes_required<uint32_t>(n, tiered::scratch_mode::stable_sort);
+    size_t keyed = tiered::scratch_bytes_required<Keyed>(n, tiered::scratch_mode::sort_by_key);
+    report("scratch_bytes_required orders the modes",
+           required >= 2 * n * sizeof(uint32_t) && stable >= required + n * sizeof(uint32_t) &&
+           keyed >= n * sizeof(Keyed) + 2 * n * sizeof(size_t) &&
+           tiered::scratch_bytes_required<uint32_t>(1) == 0 &&
+           tiered::scratch_bytes_required<uint32_t>(100) == 0 &&
+           tiered::scratch_bytes_required<uint8_t>(n) == 0);
+}
+
+// plan + execute gives std::sort's result, ascending and descending
+template<typename T>
+bool planned_matches(const std::vector<std::vector<T>>& inputs) {
+    for (const auto& in : inputs) {
+        for (auto order : {tiered::sort_order::ascending, tiered::sort_order::descending}) {
+            std::vector<T> got = in;
+            std::vector<T> want = in;
+            tiered::execute(tiered::plan(got.begin(), got.end(), order), got.begin(), got.end());
+            if (order == tiered::sort_order::descending) {
+                std::sort(want.begin(), want.end(), std::greater<T>());
+            } else {
+                std::sort(want.begin(), want.end());
+            }
+            if (got != want) return false;
+        }
+    }
+    return true;
+}
+
+void test_plan() {
+    std::cout << "\n=== Sort Planning Tests ===\n";
+
+    using tiered::tier;
+    std::mt19937_64 rng(59);
+    const size_t n = 1 << 17;
+    auto inputs = tier_inputs<uint32_t>(rng, n);
+
+    const tier expected[] = {tier::small, tier::pattern, tier::dense, tier::dense,
+                             tier::few_distinct, tier::heavy_hitters, tier::radix};
+    std::vector<tiered::sort_plan> plans;
+    bool ok = true;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        std::vector<uint32_t> before = inputs[i];
+        plans.push_back(tiered::plan(inputs[i].begin(), inputs[i].end()));
+        ok &= plans[i].chosen == expected[i] && inputs[i] == before;
+    }
+    report("plan picks the tier sort takes, data untouched", ok);
+
+    const auto& dense = plans[3];
+    const auto& radix = plans[6];
+    report("dense plan: exact bounds and histogram bytes",
+           dense.min_key == 0 && dense.max_key == n / 2 && dense.passes == 2 &&
+           dense.scratch_bytes == (n / 2 + 1) * sizeof(uint32_t));
+    report("radix plan: 4 passes, n-element buffer, costliest",
+           radix.passes == 4 && radix.scratch_bytes == n * sizeof(uint32_t) && plans[2].cost < radix.cost &&
+           plans[5].cost < radix.cost && plans[4].scratch_bytes == 0 && plans[0].n == 100);
+
+    report("uint32 execute every tier", planned_matches(inputs));
+    report("int64 execute every tier", planned_matches(tier_inputs<int64_t>(rng, n)));
+    {
+        std::vector<std::vector<uint16_t>> shorts(2);
+        shorts[0].resize(1 << 17);
+        shorts[1].resize(5000);
+        for (auto& in : shorts) for (auto& v : in) v = static_cast<uint16_t>(rng());
+        std::vector<std::vector<double>> doubles(2);
+        doubles[0].resize(n);
+        doubles[1].resize(n);
+        for (auto& v : doubles[0]) v = static_cast<double>(rng() % n) - 5000.0;
+        for (auto& v : doubles[1]) v = static_cast<double>(static_cast<int64_t>(rng())) / 7.0;
+        auto p = tiered::plan(shorts[0].begin(), shorts[0].end());
+        auto q = tiered::plan(doubles[0].begin(), doubles[0].end());
+        report("uint16 and double plans execute",
+               p.chosen == tier::direct_counting && q.chosen == tier::dense &&
+               planned_matches(shorts) && planned_matches(doubles));
+    }
+
+    // A plan that no longer matches its data still sorts it
+    std::vector<uint32_t> data = inputs[2];
+    auto stale = tiered::plan(data.begin(), data.end());
+    for (auto& v : data) v = static_cast<uint32_t>(rng());
+    std::vector<uint32_t> want = data;
+    std::sort(want.begin(), want.end());
+    tiered::execute(stale, data.begin(), data.end());
+    bool stale_ok = data == want;
+    data.resize(n / 2);
+    for (auto& v : data) v = static_cast<uint32_t>(rng());
+    tiered::execute(stale, data.begin(), data.end());
+    report("stale or mismatched plan still sorts", stale_ok && std::is_sorted(data.begin(), data.end()));
+}
+
+#if TIEREDSORT_STATS
+std::vector<tiered::sort_event> recorded_events;
+
+void record_event(const tiered::sort_event& e) {
+    recorded_events.push_back(e);
+}
+
+// Built as test_tieredsort_stats: the whole suite runs with the hooks
+// compiled in, then this checks what they recorded
+void test_stats() {
+    std::cout << "\n=== Tier Telemetry Tests ===\n";
+
+    using tiered::tier;
+    std::mt19937_64 rng(53);
+    const size_t n = 1 << 17;
+    auto inputs = tier_inputs<uint32_t>(rng, n);
+
+    tiered::global_stats().reset();
+    recorded_events.clear();
+    recorded_events.reserve(64);
+    tiered::set_stats_sink(record_event);
+    for (auto& in : inputs) tiered::sort(in.begin(), in.end());
+
+    const tier expected[] = {tier::small, tier::pattern, tier::dense, tier::dense,
+                             tier::few_distinct, tier::heavy_hitters, tier::radix};
+    bool ok = recorded_events.size() == 7;
+    for (size_t i = 0; ok && i < 7; i++) ok = recorded_events[i].chosen == expected[i];
+    report("one event per sort, with the tier each input takes", ok);
+
+    const auto& dense = recorded_events[2];
+    report("dense event: sample passed, exact key bounds, no radix pass",
+           dense.dense_sampled && dense.dense_sample_passed && dense.min_key == 0 && dense.max_key < n &&
+           dense.radix_passes == 0);
+    const auto& rebased = recorded_events[3];
+    report("dense rebase counts its histogram bytes",
+           rebased.max_key == n / 2 && rebased.bytes_allocated >= (n / 2) * sizeof(uint32_t));
+    const auto& radix = recorded_events[6];
+    report("radix event: 4 passes, temp buffer, timed phases",
+           !radix.dense_sample_passed && radix.radix_passes == 4 &&
+           radix.bytes_allocated == n * sizeof(uint32_t) && radix.n == n && radix.element_bytes == 4 &&
+           radix.detect_ns > 0 && radix.sort_ns > 0);
+    report("heavy hitters keep their tier through the tail radix sort",
+           recorded_events[5].chosen == tier::heavy_hitters && recorded_events[5].radix_passes == 4);
+
+    // Other entry points
+    std::vector<uint16_t> shorts(1 << 17);
+    for (auto& v : shorts) v = static_cast<uint16_t>(rng());
+    tiered::stable_sort(shorts.begin(), shorts.end());
+    std::vector<uint64_t> wide(5000);
+    for (auto& v : wide) v = rng() >> 8;   // top byte always 0
+    tiered::sort_bounded(wide.begin(), wide.end(), nullptr, 0);
+    std::vector<Keyed> records(1000);
+    for (auto& r : records) r.key = static_cast<int32_t>(rng());
+    tiered::sort_by_key(records.begin(), records.end(), [](const Keyed& r) { return r.key; });
+    std::vector<uint16_t> sparse(300);
+    for (auto& v : sparse) v = static_cast<uint16_t>(rng());
+    tiered::sort_by_key(sparse.begin(), sparse.end(), [](uint16_t v) { return v; });
+    tiered::set_stats_sink(nullptr);
+
+    ok = recorded_events.size() >= 10 && recorded_events[7].chosen == tier::direct_counting &&
+         recorded_events[8].chosen == tier::radix_in_place && recorded_events[8].radix_passes_skipped >= 1 &&
+         recorded_events[8].bytes_allocated == 0 && recorded_events[9].chosen == tier::comparison;
+    ok = ok && recorded_events.size() == 11 && recorded_events[10].chosen == tier::comparison &&
+         recorded_events[10].bytes_allocated < 65536 * sizeof(size_t);
+    report("stable_sort, sort_bounded and sort_by_key events (sparse 16-bit keys not counted)", ok);
+
+    auto snap = tiered::global_stats().snapshot();
+    auto at = [&snap](tier t) { return snap.tiers[static_cast<size_t>(t)]; };
+    report("aggregated counters match the events",
+           at(tier::dense).sorts == 2 && at(tier::radix).sorts == 1 && at(tier::radix).elements == n &&
+           at(tier::small).sorts == 1 && snap.radix_passes >= 8 && snap.dense_samples >= 6 &&
+           snap.dense_sample_rejects >= 3 && std::string(tiered::tier_name(tier::heavy_hitters)) == "heavy_hitters");
+    tiered::global_stats().reset();
+    report("reset clears the counters", tiered::global_stats().snapshot().tiers[static_cast<size_t>(tier::radix)].sorts == 0);
+}
+#endif
+
+// Output slot that throws when assigned poisoned_value
+uint64_t poisoned_value = 0;
+
+struct poisoned_slot {
+    uint64_t value = 0;
+
+    poisoned_slot& operator=(uint64_t v) {
+        if (v == poisoned_value) throw std::runtime_error("poisoned output");
+        value = v;
+        return *this;
+    }
+};
+
+template<typename T>
+std::vector<std::vector<T>> make_runs(std::mt19937_64& rng, size_t k, size_t max_len, uint64_t range) {
+    std::vector<std::vector<T>> runs(k);
+    for (auto& r : runs) {
+        r.resize(rng() % (max_len + 1));
+        for (auto& v : r) v = static_cast<T>(rng() % range);
+        std::sort(r.begin(), r.end());
+    }
+    return runs;
+}
+
+template<typename T>
+std::vector<T> concat_sorted(const std::vector<std::vector<T>>& runs) {
+    std::vector<T> all;
+    for (const auto& r : runs) all.insert(all.end(), r.begin(), r.end());
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+void test_merge_runs() {
+    std::cout << "\n=== Merge Runs Tests ===\n";
+
+    std::mt19937_64 rng(31);
+
+    // Fan-ins from 1 to 37, some runs empty
+    {
+        bool ok = true;
+        for (size_t k : {size_t(1), size_t(2), size_t(3), size_t(5), size_t(16), size_t(37)}) {
+            auto runs = make_runs<uint64_t>(rng, k, 3000, 1u << 20);
+            runs[k / 2].clear();
+            std::vector<uint64_t> out;
+            tiered::merge_runs(runs, std::back_inserter(out));
+            ok = ok && out == concat_sorted(runs);
+        }
+        report("k-way merge, k = 1..37", ok);
+    }
+
+    // Long non-overlapping stretches take the bulk-copy path
+    {
+        std::vector<std::vector<int32_t>> runs(4);
+        for (int32_t i = 0; i < 40000; i++) runs[static_cast<size_t>((i / 1000) % 4)].push_back(i - 20000);
+        std::vector<int32_t> out(40000);
+        auto end = tiered::merge_runs(runs, out.data());
+        report("interleaved blocks copied in bulk", end == out.data() + out.size() && out == concat_sorted(runs));
+    }
+
+    // Descending runs, and floats ordered like tiered::sort (-0.0 before 0.0)
+    {
+        auto runs = make_runs<int64_t>(rng, 9, 2000, 500);
+        for (auto& r : runs) std::reverse(r.begin(), r.end());
+        std::vector<int64_t> out;
+        tiered::merge_runs(runs, std::back_inserter(out), tiered::sort_order::descending);
+        std::vector<int64_t> expected = concat_sorted(runs);
+        std::reverse(expected.begin(), expected.end());
+
+        std::vector<std::vector<float>> fruns = {{-1.0f, -0.0f, 2.0f}, {0.0f, 0.5f}, {-0.0f, 0.0f, 3.0f}};
+        std::vector<float> fout;
+        tiered::merge_runs(fruns, std::back_inserter(fout));
+        std::vector<float> fexpected = {-1.0f, -0.0f, -0.0f, 0.0f, 0.0f, 0.5f, 2.0f, 3.0f};
+        report("descending and float merge", out == expected && same_bits(fout, fexpected));
+    }
+
+    // Runs sorted by the small and pattern tiers keep -0.0 before 0.0, so
+    // merging them gives tiered::sort's order of the whole input
+    {
+        std::vector<std::vector<double>> runs(3);
+        for (int i = 0; i < 200; i++) runs[0].push_back(i % 3 == 0 ? -0.0 : i % 3 == 1 ? 0.0 : double(i % 7) - 3.0);
+        std::shuffle(runs[0].begin(), runs[0].end(), rng);
+        for (int i = 0; i < 600; i++) runs[1].push_back(i < 200 ? double(i) - 200.0 : i < 400 ? (i % 2 ? 0.0 : -0.0) : double(i));
+        for (int i = 0; i < 50; i++) runs[2].push_back(i % 2 ? -0.0 : 0.0);
+        std::vector<double> all;
+        for (auto& r : runs) {
+            all.insert(all.end(), r.begin(), r.end());
+            tiered::sort(r.begin(), r.end());
+        }
+        tiered::sort(all.begin(), all.end());
+        std::vector<double> out;
+        tiered::merge_runs(runs, std::back_inserter(out));
+        report("merge of small/pattern-sorted runs with mixed +-0.0", same_bits(out, all));
+    }
+
+    // Parallel merge: co-ranked slices, heavy duplicates across cuts
+    {
+        bool ok = true;
+        for (uint64_t range : {uint64_t(3), uint64_t(1000), uint64_t(1) << 40}) {
+            auto runs = make_runs<uint64_t>(rng, 12, 60000, range);
+            std::vector<uint64_t> expected = concat_sorted(runs);
+            std::vector<uint64_t> out(expected.size());
+            auto end = tiered::merge_runs_parallel(runs, out.begin(), 4);
+            ok = ok && end == out.end() && out == expected;
+        }
+        auto runs = make_runs<int32_t>(rng, 6, 50000, 100000);
+        for (auto& r : runs) std::reverse(r.begin(), r.end());
+        std::vector<int32_t> expected = concat_sorted(runs);
+        std::reverse(expected.begin(), expected.end());
+        std::vector<int32_t> out(expected.size());
+        tiered::merge_runs_parallel(runs, out.begin(), 3, tiered::sort_order::descending);
+        report("parallel merge by co-ranking", ok && out == expected);
+    }
+
+    // A throwing output, in the caller's slice (the smallest value) or a
+    // worker's (the largest), reaches the caller after every thread joined
+    {
+        bool ok = true;
+        auto runs = make_runs<uint64_t>(rng, 8, 60000, uint64_t(1) << 40);
+        std::vector<uint64_t> all = concat_sorted(runs);
+        for (uint64_t poison : {all.front(), all.back()}) {
+            poisoned_value = poison;
+            std::vector<poisoned_slot> out(all.size());
+            try {
+                tiered::merge_runs_parallel(runs, out.begin(), 4);
+                ok = false;
+            } catch (const std::runtime_error&) {
+            }
+        }
+        report("parallel merge rethrows output exceptions", ok);
+    }
+}
+
+void test_stream_sorter() {
+    std::cout << "\n=== Stream Sorter Tests ===\n";
+
+    std::mt19937_64 rng(29);
+
+    // Batches of varied size; the run count stays logarithmic
+    {
+        tiered::stream_sorter<uint64_t> s;
+        std::vector<uint64_t> all;
+        size_t max_runs = 0;
+        for (int b = 0; b < 300; b++) {
+            std::vector<uint64_t> batch(rng() % 2000);
+            for (auto& v : batch) v = rng() % 100000;
+            all.insert(all.end(), batch.begin(), batch.end());
+            s.push(batch);
+            max_runs = std::max(max_runs, s.run_count());
+        }
+        bool size_ok = s.size() == all.size();
+        std::sort(all.begin(), all.end());
+        std::vector<uint64_t> sorted = s.finish();
+        report("batches merged on finish", size_ok && sorted == all && max_runs <= 22 && s.size() == 0);
+    }
+
+    // Descending drain into an output iterator, then reuse
+    {
+        tiered::stream_sorter<int32_t> s(tiered::sort_order::descending);
+        std::vector<int32_t> all;
+        for (int b = 0; b < 50; b++) {
+            std::vector<int32_t> batch(1 + rng() % 700);
+            for (auto& v : batch) v = static_cast<int32_t>(rng() % 1000) - 500;
+            all.insert(all.end(), batch.begin(), batch.end());
+            s.push(batch.begin(), batch.end());
+        }
+        std::vector<int32_t> out;
+        s.drain(std::back_inserter(out));
+        std::sort(all.begin(), all.end(), std::greater<int32_t>());
+        bool first_ok = out == all;
+
+        std::vector<int32_t> again = {3, 1, 2};
+        s.push(again);
+        report("descending drain and reuse", first_ok && s.finish() == std::vector<int32_t>{3, 2, 1});
+    }
+
+    // Presorted stream (runs already in order), single values, empty sorter
+    {
+        tiered::stream_sorter<double> s;
+        std::vector<double> all;
+        for (int i = 0; i < 5000; i++) {
+            double v = i * 0.5;
+            s.push(&v, &v + 1);
+            all.push_back(v);
+        }
+        tiered::stream_sorter<double> empty;
+        report("presorted single values and empty sorter", s.finish() == all && empty.finish().empty());
+    }
+}
+
+template<typename T>
+void write_test_file(const std::string& path, const std::vector<T>& data) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!data.empty()) std::fwrite(data.data(), sizeof(T), data.size(), f);
+    std::fclose(f);
+}
+
+template<typename T>
+std::vector<T> read_test_file(const std::string& path) {
+    std::vector<T> data(std::filesystem::file_size(path) / sizeof(T));
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    size_t got = std::fread(data.data(), sizeof(T), data.size(), f);
+    std::fclose(f);
+    data.resize(got);
+    return data;
+}
+
+void test_external_sort() {
+    std::cout << "\n=== External Sort Tests ===\n";
+
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "tieredsort_external_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "runs");
+    const std::string input = (dir / "input.bin").string();
+    const std::string output = (dir / "output.bin").string();
+    std::mt19937_64 rng(17);
+
+    tiered::external_sort_options small;
+    small.memory_bytes = 256 << 10;
+    small.temp_dir = (dir / "runs").string();
+
+    // Many runs, more than one merge pass
+    {
+        std::vector<uint64_t> data(300000);
+        for (auto& v : data) v = rng();
+        write_test_file(input, data);
+        tiered::external_sort<uint64_t>(input, output, small);
+        std::sort(data.begin(), data.end());
+        report("uint64 multi-pass merge", read_test_file<uint64_t>(output) == data && fs::is_empty(dir / "runs"));
+    }
+
+    // Fan-in capped below what the budget allows (the open-file cap):
+    // 9 runs through 3-way merges
+    {
+        std::vector<uint64_t> data(1400000);
+        for (auto& v : data) v = rng();
+        write_test_file(input, data);
+        tiered::external_sort_options opts = small;
+        opts.memory_bytes = 4 << 20;
+        opts.max_fan_in = 3;
+        tiered::external_sort<uint64_t>(input, output, opts);
+        std::sort(data.begin(), data.end());
+        report("uint64 runs over the fan-in cap", read_test_file<uint64_t>(output) == data && fs::is_empty(dir / "runs"));
+    }
+
+    // Descending, duplicates, output over the input
+    {
+        std::vector<int32_t> data(200001);
+        for (auto& v : data) v = static_cast<int32_t>(rng() % 5000) - 2500;
+        write_test_file(input, data);
+        tiered::external_sort_options opts = small;
+        opts.memory_bytes = 1 << 20;
+        tiered::external_sort<int32_t>(input, input, opts, tiered::sort_order::descending);
+        std::sort(data.begin(), data.end(), std::greater<int32_t>());
+        report("int32 descending in place", read_test_file<int32_t>(input) == data);
+    }
+
+    // Fits in memory: one in-memory sort, no runs
+    {
+        std::vector<double> data(10000);
+        for (auto& v : data) v = static_cast<double>(rng() % 1000000) / 7.0;
+        write_test_file(input, data);
+        tiered::external_sort<double>(input, output, small);
+        std::sort(data.begin(), data.end());
+        report("double single chunk", read_test_file<double>(output) == data);
+    }
+
+    // Empty input, and a size that is not a whole number of records
+    {
+        write_test_file(input, std::vector<uint64_t>());
+        tiered::external_sort<uint64_t>(input, output, small);
+        bool empty_ok = fs::file_size(output) == 0;
+
+        write_test_file(input, std::vector<uint8_t>(12));
+        bool threw = false;
+        try {
+            tiered::external_sort<uint64_t>(input, output, small);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        report("empty and malformed input files", empty_ok && threw);
+    }
+
+    fs::remove_all(dir);
+}
+
+void test_sort_file() {
+    std::cout << "\n=== Mapped File Sort Tests ===\n";
+
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "tieredsort_file_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string path = (dir / "data.bin").string();
+    std::mt19937_64 rng(23);
+
+    // Scratch in anonymous memory (default budget)
+    {
+        std::vector<uint64_t> data(200000);
+        for (auto& v : data) v = rng();
+        write_test_file(path, data);
+        tiered::sort_file<uint64_t>(path);
+        std::sort(data.begin(), data.end());
+        report("uint64 file, anonymous scratch", read_test_file<uint64_t>(path) == data);
+    }
+
+    // Over budget: scratch in a mapped temp file, which is cleaned up
+    {
+        std::vector<float> data(150000);
+        for (auto& v : data) v = static_cast<float>(static_cast<int64_t>(rng() % 2000000) - 1000000) / 3.0f;
+        write_test_file(path, data);
+        tiered::file_sort_options opts;
+        opts.memory_bytes = 0;
+        opts.temp_dir = dir.string();
+        tiered::sort_file<float>(path, opts, tiered::sort_order::descending);
+        std::sort(data.begin(), data.end(), std::greater<float>());
+        size_t files = static_cast<size_t>(std::distance(fs::directory_iterator(dir), fs::directory_iterator()));
+        report("float file descending, file-backed scratch", read_test_file<float>(path) == data && files == 1);
+    }
+
+    // Dense data over budget: the counting histogram is file-backed too
+    {
+        std::vector<uint32_t> data(300000);
+        for (auto& v : data) v = static_cast<uint32_t>(rng() % 400000);
+        write_test_file(path, data);
+        tiered::file_sort_options opts;
+        opts.memory_bytes = 0;
+        opts.temp_dir = dir.string();
+        tiered::sort_file<uint32_t>(path, opts);
+        std::sort(data.begin(), data.end());
+        report("uint32 dense file, histogram within budget", read_test_file<uint32_t>(path) == data);
+    }
+
+    // Empty file, and a size that is not a whole number of records
+    {
+        write_test_file(path, std::vector<uint32_t>());
+        tiered::sort_file<uint32_t>(path);
+        bool empty_ok = fs::file_size(path) == 0;
+
+        write_test_file(path, std::vector<uint8_t>(6));
+        bool threw = false;
+        try {
+            tiered::sort_file<uint32_t>(path);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        report("empty and malformed files", empty_ok && threw);
+    }
+
+    fs::remove_all(dir);
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -698,11 +2869,41 @@ int main() {
     test_uint64();
     test_float();
     test_double();
+    test_small_types();
+    test_half_floats();
     test_buffer_api();
     test_raw_arrays();
     test_stress();
     test_stable_sort();
     test_sort_by_key();
+    test_descending();
+    test_sort_by_small_key();
+#ifdef TIEREDSORT_HAS_INT128
+    test_int128();
+#endif
+    test_sort_by_byte_key();
+    test_sort_strings();
+    test_selection();
+    test_quantiles();
+    test_sort_unique();
+    test_few_distinct();
+    test_heavy_hitters();
+    test_dense_detection();
+    test_integral_floats();
+    test_sorter();
+#ifdef TIEREDSORT_HAS_PMR
+    test_memory_resource();
+#endif
+    test_huge_pages();
+    test_sort_bounded();
+    test_plan();
+#if TIEREDSORT_STATS
+    test_stats();
+#endif
+    test_merge_runs();
+    test_stream_sorter();
+    test_external_sort();
+    test_sort_file();
 
     std::cout << "\n========================================\n";
     std::cout << "Results: " << tests_passed << " passed, " << tests_failed << " failed\n";